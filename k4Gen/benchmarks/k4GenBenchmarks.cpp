@@ -0,0 +1,372 @@
+/** k4GenBenchmarks
+ *
+ *  Benchmarks of the per-event kernels of the k4Gen components: HepMC merging, HepMC to EDM4hep conversion,
+ *  HepEVT and MDI parsing, vertex smearing, single- and multi-particle gun generation and the kT clustering of the
+ *  matching variables with KtClustering and Pythia8::SlowJet. The inputs are synthetic
+ *  and generated in-process. The components are compiled into this executable and created in a minimal Gaudi
+ *  application without event loop, so no job options or input files are needed.
+ *
+ *  For regression tracking, write the results as JSON:
+ *    k4GenBenchmarks --benchmark_out=k4GenBenchmarks.json --benchmark_out_format=json
+ */
+
+#include "HepEVTReader.h"
+#include "HepMCToEDMConverter.h"
+#include "KtClustering.h"
+#include "MDIReader.h"
+
+#include "Generation/IHepMCMergeTool.h"
+#include "Generation/IParticleGunTool.h"
+#include "Generation/IVertexSmearingTool.h"
+
+#include "Gaudi/Interfaces/IOptionsSvc.h"
+#include "GaudiKernel/Bootstrap.h"
+#include "GaudiKernel/IAppMgrUI.h"
+#include "GaudiKernel/IProperty.h"
+#include "GaudiKernel/ISvcLocator.h"
+#include "GaudiKernel/IToolSvc.h"
+#include "GaudiKernel/SmartIF.h"
+#include "GaudiKernel/System.h"
+
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+#include "edm4hep/MCParticleCollection.h"
+
+#include "Pythia8/Pythia.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The components and the application are created once and live until the end of the process.
+
+/// Minimal Gaudi application providing the services the components need, created on first use
+ISvcLocator* gaudiServices() {
+  static SmartIF<IAppMgrUI> app = [] {
+    SmartIF<IAppMgrUI> appMgr(Gaudi::createApplicationMgr());
+    auto properties = appMgr.as<IProperty>();
+    properties->setProperty("JobOptionsType", "NONE").ignore();
+    properties->setProperty("EvtSel", "NONE").ignore();
+    properties->setProperty("EvtMax", "0").ignore();
+    properties->setProperty("OutputLevel", "4").ignore();
+    properties->setProperty("ExtSvc", "['RndmGenSvc', 'k4DataSvc/EventDataSvc']").ignore();
+    if (appMgr->configure().isFailure() || appMgr->initialize().isFailure())
+      throw std::runtime_error("Cannot start the Gaudi application");
+    return appMgr;
+  }();
+  return app.as<ISvcLocator>().get();
+}
+
+/// Public tool of the given type, created and initialized on first use
+template <typename T>
+T* gaudiTool(const std::string& type) {
+  SmartIF<IToolSvc> toolSvc = gaudiServices()->service("ToolSvc");
+  T* tool = nullptr;
+  if (!toolSvc || toolSvc->retrieveTool(type, tool).isFailure())
+    throw std::runtime_error("Cannot create tool " + type);
+  return tool;
+}
+
+HepMC3::FourVector randomMomentum(std::mt19937& rng, double mass) {
+  std::uniform_real_distribution<double> flat(-1., 1.);
+  double px = 10. * flat(rng), py = 10. * flat(rng), pz = 50. * flat(rng);
+  return HepMC3::FourVector(px, py, pz, std::sqrt(px * px + py * py + pz * pz + mass * mass));
+}
+
+/** Synthetic event with the structure of a generator event: two beam particles entering a hard vertex, and
+ *  outgoing particles of which a fraction are intermediate hadrons decaying into two final-state particles.
+ *  @param[in] nParticles  approximate number of particles besides the beams
+ */
+HepMC3::GenEvent makeEvent(int nParticles, std::mt19937& rng) {
+  std::uniform_real_distribution<double> flat(-1., 1.);
+  HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+  auto hardVertex = std::make_shared<HepMC3::GenVertex>();
+  hardVertex->add_particle_in(std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, 7000, 7000), 2212, 4));
+  hardVertex->add_particle_in(std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, -7000, 7000), 2212, 4));
+  event.add_vertex(hardVertex);
+
+  int n = 0;
+  while (n < nParticles) {
+    if (n % 3 == 0 && n + 3 <= nParticles) {
+      auto momentum = randomMomentum(rng, 0.775);
+      auto mother = std::make_shared<HepMC3::GenParticle>(momentum, 113, 2);
+      hardVertex->add_particle_out(mother);
+      auto decayVertex = std::make_shared<HepMC3::GenVertex>(
+          HepMC3::FourVector(0.01 * flat(rng), 0.01 * flat(rng), 0.1 * flat(rng), 0.));
+      decayVertex->add_particle_in(mother);
+      decayVertex->add_particle_out(std::make_shared<HepMC3::GenParticle>(momentum * 0.5, 211, 1));
+      decayVertex->add_particle_out(std::make_shared<HepMC3::GenParticle>(momentum * 0.5, -211, 1));
+      event.add_vertex(decayVertex);
+      n += 3;
+    } else {
+      hardVertex->add_particle_out(std::make_shared<HepMC3::GenParticle>(randomMomentum(rng, 0.), 22, 1));
+      n += 1;
+    }
+  }
+  return event;
+}
+
+/// Signal event merged with state.range(0) pileup events of 200 particles each
+void benchmarkMerge(benchmark::State& state, const std::string& toolType) {
+  auto mergeTool = gaudiTool<IHepMCMergeTool>(toolType);
+  std::mt19937 rng(1);
+  const HepMC3::GenEvent signalEvent = makeEvent(200, rng);
+  std::vector<HepMC3::GenEvent> pileUpEvents;
+  for (int i = 0; i < state.range(0); ++i)
+    pileUpEvents.push_back(makeEvent(200, rng));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto mergedEvent = std::make_unique<HepMC3::GenEvent>(signalEvent);
+    state.ResumeTiming();
+    mergeTool->merge(*mergedEvent, pileUpEvents).ignore();
+    benchmark::DoNotOptimize(mergedEvent->particles().size());
+    state.PauseTiming();
+    mergedEvent.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// As benchmarkMerge, with the pileup events merged one by one as throwaway events, like GenAlg does
+void benchmarkMergeConsumed(benchmark::State& state, const std::string& toolType) {
+  auto mergeTool = gaudiTool<IHepMCMergeTool>(toolType);
+  std::mt19937 rng(1);
+  const HepMC3::GenEvent signalEvent = makeEvent(200, rng);
+  std::vector<HepMC3::GenEvent> pileUpEvents;
+  for (int i = 0; i < state.range(0); ++i)
+    pileUpEvents.push_back(makeEvent(200, rng));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto mergedEvent = std::make_unique<HepMC3::GenEvent>(signalEvent);
+    std::vector<HepMC3::GenEvent> throwaway(pileUpEvents);
+    state.ResumeTiming();
+    for (auto& pileUpEvent : throwaway)
+      mergeTool->merge(*mergedEvent, std::move(pileUpEvent)).ignore();
+    benchmark::DoNotOptimize(mergedEvent->particles().size());
+    state.PauseTiming();
+    mergedEvent.reset();
+    throwaway.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_HepMCSimpleMerge(benchmark::State& state) { benchmarkMerge(state, "HepMCSimpleMerge"); }
+void BM_HepMCFullMerge(benchmark::State& state) { benchmarkMerge(state, "HepMCFullMerge"); }
+void BM_HepMCSimpleMergeConsumed(benchmark::State& state) { benchmarkMergeConsumed(state, "HepMCSimpleMerge"); }
+void BM_HepMCFullMergeConsumed(benchmark::State& state) { benchmarkMergeConsumed(state, "HepMCFullMerge"); }
+BENCHMARK(BM_HepMCSimpleMerge)->Arg(1)->Arg(10)->Arg(200)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HepMCFullMerge)->Arg(1)->Arg(10)->Arg(200)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HepMCSimpleMergeConsumed)->Arg(1)->Arg(10)->Arg(200)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HepMCFullMergeConsumed)->Arg(1)->Arg(10)->Arg(200)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+/// Conversion of an event with state.range(0) particles
+void BM_HepMCToEDMConversion(benchmark::State& state) {
+  static auto converter = new HepMCToEDMConverter("HepMCToEDMConverter", gaudiServices());
+  std::mt19937 rng(2);
+  const HepMC3::GenEvent event = makeEvent(state.range(0), rng);
+
+  for (auto _ : state) {
+    edm4hep::MCParticleCollection particles;
+    converter->convertEvent(event, particles);
+    benchmark::DoNotOptimize(particles.size());
+  }
+  state.SetItemsProcessed(state.iterations() * event.particles().size());
+}
+BENCHMARK(BM_HepMCToEDMConversion)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Parsing of a HepEVT event with state.range(0) particles
+void BM_HepEVTParsing(benchmark::State& state) {
+  static auto reader = new HepEVTReader("HepEVTReader", gaudiServices());
+  std::mt19937 rng(3);
+  std::ostringstream text;
+  for (int i = 0; i < state.range(0); ++i) {
+    auto p = randomMomentum(rng, 0.13957);
+    text << "1 211 0 0 0 0 " << p.px() << " " << p.py() << " " << p.pz() << " " << p.e() << " 0.13957 0 0 0 0\n";
+  }
+  const std::string content = text.str();
+
+  for (auto _ : state) {
+    std::istringstream input(content);
+    edm4hep::MCParticleCollection particles;
+    reader->readEvent(input, state.range(0), particles).ignore();
+    benchmark::DoNotOptimize(particles.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_HepEVTParsing)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Parsing of a GuineaPig pair file with state.range(0) particles
+void BM_MDIParsing(benchmark::State& state) {
+  static auto reader = [] {
+    auto mdiReader = new MDIReader("MDIReader", gaudiServices());
+    mdiReader->setProperty("InputType", std::string("guineapig")).ignore();
+    mdiReader->setProperty("CrossingAngle", 0.015).ignore();
+    mdiReader->setProperty("LongitudinalCut", 0.).ignore();
+    mdiReader->setProperty("BeamEnergy", 45.6).ignore();
+    return mdiReader;
+  }();
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<double> flat(-1., 1.);
+  std::ostringstream text;
+  for (int i = 0; i < state.range(0); ++i) {
+    text << 5. * flat(rng) << " " << 0.01 * flat(rng) << " " << 0.01 * flat(rng) << " " << flat(rng) << " "
+         << 100. * flat(rng) << " " << 100. * flat(rng) << " " << 1000. * flat(rng) << " 1 0 " << i / 2 << "\n";
+  }
+  const std::string content = text.str();
+
+  for (auto _ : state) {
+    std::istringstream input(content);
+    edm4hep::MCParticleCollection particles;
+    reader->readParticles(input, particles).ignore();
+    benchmark::DoNotOptimize(particles.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_MDIParsing)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Smearing of all vertices of an event with state.range(0) particles
+void benchmarkSmearing(benchmark::State& state, const std::string& toolType) {
+  auto smearingTool = gaudiTool<IVertexSmearingTool>(toolType);
+  std::mt19937 rng(5);
+  HepMC3::GenEvent event = makeEvent(state.range(0), rng);
+
+  for (auto _ : state) {
+    smearingTool->smearVertex(event).ignore();
+  }
+  state.SetItemsProcessed(state.iterations() * event.vertices().size());
+}
+
+void BM_GaussSmearVertex(benchmark::State& state) { benchmarkSmearing(state, "GaussSmearVertex"); }
+void BM_FlatSmearVertex(benchmark::State& state) { benchmarkSmearing(state, "FlatSmearVertex"); }
+BENCHMARK(BM_GaussSmearVertex)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FlatSmearVertex)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Generation of single-particle events
+void BM_MomentumRangeParticleGun(benchmark::State& state) {
+  auto particleGun = gaudiTool<IParticleGunTool>("MomentumRangeParticleGun");
+
+  for (auto _ : state) {
+    HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+    particleGun->getNextEvent(event).ignore();
+    benchmark::DoNotOptimize(event.particles().size());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MomentumRangeParticleGun);
+
+/// Kinematics of many particles, drawn one by one or as one batch
+void BM_ParticleGunSingleDraws(benchmark::State& state) {
+  auto particleGun = gaudiTool<IParticleGunTool>("MomentumRangeParticleGun");
+  Gaudi::LorentzVector momentum, origin;
+  int pdgId;
+
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      particleGun->generateParticle(momentum, origin, pdgId);
+      benchmark::DoNotOptimize(momentum);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+void BM_ParticleGunBatchDraws(benchmark::State& state) {
+  auto particleGun = gaudiTool<IParticleGunTool>("MomentumRangeParticleGun");
+  std::vector<Gaudi::LorentzVector> momenta, origins;
+  std::vector<int> pdgIds;
+
+  for (auto _ : state) {
+    particleGun->generateParticles(state.range(0), momenta, origins, pdgIds);
+    benchmark::DoNotOptimize(momenta.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParticleGunSingleDraws)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParticleGunBatchDraws)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+
+/// Generation of multi-particle events in one pass, on a shared vertex
+void BM_MultiParticleGun(benchmark::State& state) {
+  const std::string name = "MultiParticleGun" + std::to_string(state.range(0));
+  gaudiServices()->getOptsSvc().set("ToolSvc." + name + ".numParticles", std::to_string(state.range(0)));
+  auto particleGun = gaudiTool<IParticleGunTool>("MultiParticleGun/" + name);
+
+  for (auto _ : state) {
+    HepMC3::GenEvent event(HepMC3::Units::GEV, HepMC3::Units::MM);
+    particleGun->getNextEvent(event).ignore();
+    benchmark::DoNotOptimize(event.particles().size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MultiParticleGun)->RangeMultiplier(10)->Range(10, 1000)->Unit(benchmark::kMicrosecond);
+
+/// Particle database for the synthetic Pythia8 events, read once
+Pythia8::ParticleData& pythiaParticleData() {
+  static const std::string xmlpath =
+      System::getEnv("PYTHIA8_XML") != "UNKNOWN" ? System::getEnv("PYTHIA8_XML") : "../share/Pythia8/xmldoc";
+  static Pythia8::Pythia pythia(xmlpath, false);
+  return pythia.particleData;
+}
+
+/// Jet clustering input like in PythiaInterface: state.range(0) final-state pions flat in |eta| < 5 with falling pt
+Pythia8::Event makeJetInput(int nParticles) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> flat(0., 1.);
+  Pythia8::Event event;
+  event.init("jet input", &pythiaParticleData());
+  for (int i = 0; i < nParticles; ++i) {
+    const double pt = 0.2 - 2. * std::log(flat(rng)), eta = 10. * flat(rng) - 5., phi = 2. * M_PI * flat(rng);
+    const double mass = 0.13957;
+    Pythia8::Vec4 p(pt * std::cos(phi), pt * std::sin(phi), pt * std::sinh(eta), 0.);
+    p.e(std::sqrt(p.pAbs2() + mass * mass));
+    event.append(i % 3 == 0 ? 111 : (i % 3 == 1 ? 211 : -211), 1, 0, 0, p, mass);
+  }
+  return event;
+}
+
+/// Clustering of the matching variables with the nearest-neighbour kT clustering and with SlowJet, as configured in
+/// PythiaInterface. Compare both at the same multiplicity to choose the jetBackend.
+void BM_KtClustering(benchmark::State& state) {
+  const Pythia8::Event event = makeJetInput(state.range(0));
+  KtClustering clustering(0.4, 4.4);
+
+  for (auto _ : state) {
+    clustering.analyze(event);
+    benchmark::DoNotOptimize(clustering.scales().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+void BM_SlowJet(benchmark::State& state) {
+  const Pythia8::Event event = makeJetInput(state.range(0));
+  Pythia8::SlowJet slowJet(1, 0.4, 0, 4.4, 2, 2, nullptr, false);
+  std::vector<double> scales;
+
+  for (auto _ : state) {
+    slowJet.setup(event);
+    scales.clear();
+    while (slowJet.sizeAll() - slowJet.sizeJet() > 0) {
+      scales.push_back(std::sqrt(slowJet.dNext()));
+      slowJet.doStep();
+    }
+    benchmark::DoNotOptimize(scales.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KtClustering)->Arg(100)->Arg(300)->Arg(1000)->Arg(3000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SlowJet)->Arg(100)->Arg(300)->Arg(1000)->Arg(3000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
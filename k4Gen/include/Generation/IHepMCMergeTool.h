@@ -13,10 +13,19 @@
 
 class IHepMCMergeTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(IHepMCMergeTool, 1, 0);
+  DeclareInterfaceID(IHepMCMergeTool, 2, 0);
 
   /// Turn a signal event and a vector of pileup events into a merged event.
+  /// The particles and vertices of every merged event are recorded as one interaction (see PileUpInteractionRanges.h).
   virtual StatusCode merge(HepMC3::GenEvent& signalEvent, const std::vector<HepMC3::GenEvent>& eventVector) = 0;
+
+  /// Merge a single pileup event into the signal event, so that pileup can be generated and merged one event at a time.
+  /// The interaction is not recorded; the caller collects the interactions of the event with a
+  /// PileUpInteractionRanges::Collector and stores them once.
+  virtual StatusCode merge(HepMC3::GenEvent& signalEvent, const HepMC3::GenEvent& pileUpEvent) = 0;
+
+  /// Merge a single pileup event that is not needed afterwards. Its contents are consumed and it is left empty.
+  virtual StatusCode merge(HepMC3::GenEvent& signalEvent, HepMC3::GenEvent&& pileUpEvent) = 0;
 };
 
 #endif // GENERATION_IHEPMCMERGETOOL_H
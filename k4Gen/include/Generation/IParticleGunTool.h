@@ -7,7 +7,7 @@
 
 /** @class IParticleGunTool IParticleGunTool.h "Generation/IParticleGunTool.h"
  *
- *  Abstract interface to particle gun tool. Generates a single particle.
+ *  Abstract interface to particle gun tool. Generates a single particle, or a batch of particles.
  *
  *  @author Patrick Robbe
  *  @date   2008-05-18
@@ -15,7 +15,7 @@
 
 class IParticleGunTool : virtual public IHepMCProviderTool {
 public:
-  DeclareInterfaceID(IParticleGunTool, 1, 0);
+  DeclareInterfaceID(IParticleGunTool, 2, 0);
   typedef std::vector<int> PIDs;
 
   /** Generates one particle.
@@ -25,6 +25,15 @@ public:
    */
   virtual void generateParticle(Gaudi::LorentzVector& fourMomentum, Gaudi::LorentzVector& origin, int& pdgId) = 0;
 
+  /** Generates a batch of particles, drawing the random numbers in blocks.
+   *  @param[in]  n             number of particles to generate
+   *  @param[out] fourMomenta   four-momenta of the generated particles, resized to n
+   *  @param[out] origins       four-momenta of the origin vertices of the particles, resized to n
+   *  @param[out] pdgIds        pdgIds of the generated particles, resized to n
+   */
+  virtual void generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& fourMomenta,
+                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds) = 0;
+
   /// Print various counters at the end of the job
   virtual void printCounters() = 0;
 };
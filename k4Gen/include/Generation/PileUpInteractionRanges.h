@@ -0,0 +1,93 @@
+#ifndef GENERATION_PILEUPINTERACTIONRANGES_H
+#define GENERATION_PILEUPINTERACTIONRANGES_H
+
+#include "HepMC3/Attribute.h"
+#include "HepMC3/GenEvent.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @file PileUpInteractionRanges.h "Generation/PileUpInteractionRanges.h"
+ *
+ *  Bookkeeping of the pileup interactions merged into a HepMC event. Every merge appends the particles and vertices of
+ *  one interaction at the end of the event, so an interaction is identified by the [begin, end) ranges of its particle
+ *  and vertex indices. The ranges are stored as flat lists of begin/end pairs in the event attributes
+ *  "pileup_particle_ranges" and "pileup_vertex_ranges", in the order of the merges. Particles and vertices before the
+ *  first range belong to the signal.
+ */
+namespace PileUpInteractionRanges {
+
+const std::string particleRangesAttribute = "pileup_particle_ranges";
+const std::string vertexRangesAttribute = "pileup_vertex_ranges";
+
+using Range = std::pair<int, int>;
+
+namespace detail {
+inline void append(HepMC3::GenEvent& event, const std::string& name, const std::vector<int>& values) {
+  auto attribute = event.attribute<HepMC3::VectorIntAttribute>(name);
+  if (!attribute) {
+    event.add_attribute(name, std::make_shared<HepMC3::VectorIntAttribute>(values));
+    return;
+  }
+  std::vector<int> ranges = attribute->value();
+  ranges.insert(ranges.end(), values.begin(), values.end());
+  attribute->set_value(ranges);
+}
+
+inline std::vector<Range> read(const HepMC3::GenEvent& event, const std::string& name) {
+  std::vector<Range> ranges;
+  auto attribute = event.attribute<HepMC3::VectorIntAttribute>(name);
+  if (!attribute)
+    return ranges;
+  const auto& values = attribute->value();
+  for (std::size_t i = 0; i + 1 < values.size(); i += 2)
+    ranges.emplace_back(values[i], values[i + 1]);
+  return ranges;
+}
+} // namespace detail
+
+/** Ranges of the interactions merged into an event, collected while merging and stored in the event attributes at
+ *  once: a HepMC3 attribute can only be replaced as a whole, so storing every interaction on its own would copy the
+ *  ranges of all earlier interactions each time.
+ */
+class Collector {
+public:
+  /// Add everything added to the event after the given numbers of particles and vertices as one interaction
+  void add(const HepMC3::GenEvent& event, int firstParticle, int firstVertex) {
+    m_particleRanges.push_back(firstParticle);
+    m_particleRanges.push_back(event.particles().size());
+    m_vertexRanges.push_back(firstVertex);
+    m_vertexRanges.push_back(event.vertices().size());
+  }
+
+  /// Append the collected ranges to those of the event, creating the attributes even if no interaction was added
+  void store(HepMC3::GenEvent& event) const {
+    detail::append(event, particleRangesAttribute, m_particleRanges);
+    detail::append(event, vertexRangesAttribute, m_vertexRanges);
+  }
+
+private:
+  std::vector<int> m_particleRanges;
+  std::vector<int> m_vertexRanges;
+};
+
+/// Whether the event has pileup interaction ranges, i.e. pileup was merged into it (possibly none)
+inline bool present(const HepMC3::GenEvent& event) {
+  return event.attribute<HepMC3::VectorIntAttribute>(particleRangesAttribute) != nullptr;
+}
+
+/// Particle index ranges of the merged pileup interactions
+inline std::vector<Range> particleRanges(const HepMC3::GenEvent& event) {
+  return detail::read(event, particleRangesAttribute);
+}
+
+/// Vertex index ranges of the merged pileup interactions
+inline std::vector<Range> vertexRanges(const HepMC3::GenEvent& event) {
+  return detail::read(event, vertexRangesAttribute);
+}
+
+} // namespace PileUpInteractionRanges
+
+#endif // GENERATION_PILEUPINTERACTIONRANGES_H
@@ -0,0 +1,48 @@
+#ifndef GENERATION_PILEUPPARTICLES_H
+#define GENERATION_PILEUPPARTICLES_H
+
+#include <cstddef>
+#include <vector>
+
+/** @class PileUpParticles PileUpParticles.h "Generation/PileUpParticles.h"
+ *
+ *  Final-state particles of all pileup interactions of an event, stored as one array per quantity.
+ *  A compact alternative to merging the pileup into the signal HepMC event, written by GenAlg with compactPileUp.
+ *  Units are those of the HepMC event: GeV for momenta, energies and masses, mm for positions and mm/c for times.
+ *  The mass is the generated mass, it cannot be recovered from the single-precision four-momentum.
+ */
+struct PileUpParticles {
+  std::vector<float> px, py, pz, e, m;
+  std::vector<int> pdg, status;
+  std::vector<float> vx, vy, vz, t;
+  /// Index of the pileup interaction the particle comes from, starting at 0
+  std::vector<unsigned int> interaction;
+
+  std::size_t size() const { return pdg.size(); }
+
+  void reserve(std::size_t n) {
+    for (auto* v : {&px, &py, &pz, &e, &m, &vx, &vy, &vz, &t})
+      v->reserve(n);
+    pdg.reserve(n);
+    status.reserve(n);
+    interaction.reserve(n);
+  }
+
+  void push_back(double pxIn, double pyIn, double pzIn, double eIn, double mIn, int pdgIn, int statusIn, double vxIn,
+                 double vyIn, double vzIn, double tIn, unsigned int interactionIn) {
+    px.push_back(pxIn);
+    py.push_back(pyIn);
+    pz.push_back(pzIn);
+    e.push_back(eIn);
+    m.push_back(mIn);
+    pdg.push_back(pdgIn);
+    status.push_back(statusIn);
+    vx.push_back(vxIn);
+    vy.push_back(vyIn);
+    vz.push_back(vzIn);
+    t.push_back(tIn);
+    interaction.push_back(interactionIn);
+  }
+};
+
+#endif // GENERATION_PILEUPPARTICLES_H
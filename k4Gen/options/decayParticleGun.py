@@ -0,0 +1,42 @@
+from Gaudi.Configuration import *
+from GaudiKernel import SystemOfUnits as units
+
+from Configurables import ApplicationMgr
+ApplicationMgr(
+               EvtSel='NONE',
+               EvtMax=10,
+               OutputLevel=INFO,
+              )
+
+from Configurables import k4DataSvc
+podioevent = k4DataSvc("EventDataSvc")
+ApplicationMgr().ExtSvc += [podioevent]
+
+# B+ mesons from the particle gun, decayed by Pythia8
+# (set doEvtGenDecays = True to use the EvtGen decay tables instead)
+from Configurables import MomentumRangeParticleGun
+guntool = MomentumRangeParticleGun("ParticleGun", PdgCodes=[521])
+guntool.MomentumMin = 10*units.GeV
+guntool.MomentumMax = 50*units.GeV
+
+from Configurables import DecayParticleGun
+decaytool = DecayParticleGun("SignalProvider")
+decaytool.ParticleGunTool = guntool
+decaytool.pythiaExtraSettings = ["Next:numberShowEvent = 0"]
+
+from Configurables import GenAlg
+gen = GenAlg()
+gen.SignalProvider = decaytool
+gen.hepmc.Path = "hepmc"
+ApplicationMgr().TopAlg += [gen]
+
+from Configurables import HepMCToEDMConverter
+hepmc_converter = HepMCToEDMConverter()
+hepmc_converter.hepmc.Path="hepmc"
+hepmc_converter.GenParticles.Path = "GenParticles"
+ApplicationMgr().TopAlg += [hepmc_converter]
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = "output_decayParticleGun.root")
+out.outputCommands = ["keep *"]
+ApplicationMgr().TopAlg += [out]
@@ -0,0 +1,53 @@
+from Gaudi.Configuration import *
+from GaudiKernel import SystemOfUnits as units
+
+from Configurables import ApplicationMgr
+ApplicationMgr(
+               EvtSel='NONE',
+               EvtMax=10,
+               OutputLevel=INFO,
+              )
+
+from Configurables import k4DataSvc
+podioevent = k4DataSvc("EventDataSvc")
+ApplicationMgr().ExtSvc += [podioevent]
+
+from Configurables import ConstPtParticleGun
+guntool1 = ConstPtParticleGun("SignalProvider", PdgCodes=[-211], PtMin=50, PtMax=50)
+guntool2 = ConstPtParticleGun("PileUpProvider", PdgCodes=[11], writeParticleGunBranches=False)
+from Configurables import ConstPileUp
+pileuptool = ConstPileUp(numPileUpEvents=200)
+from Configurables import FlatSmearVertex
+smeartool = FlatSmearVertex()
+smeartool.zVertexMin = -30*units.mm
+smeartool.zVertexMax = 30*units.mm
+
+# the pileup is kept out of the signal HepMC event and stored in the compact side product
+from Configurables import GenAlg
+gun = GenAlg()
+gun.SignalProvider = guntool1
+gun.PileUpProvider = guntool2
+gun.PileUpTool = pileuptool
+gun.VertexSmearingTool = smeartool
+gun.compactPileUp = True
+gun.hepmc.Path = "hepmc"
+gun.pileUpParticles.Path = "pileUpParticles"
+ApplicationMgr().TopAlg += [gun]
+
+from Configurables import HepMCToEDMConverter
+hepmc_converter = HepMCToEDMConverter()
+hepmc_converter.hepmc.Path = "hepmc"
+hepmc_converter.GenParticles.Path = "GenParticles"
+ApplicationMgr().TopAlg += [hepmc_converter]
+
+from Configurables import PileUpToEDMConverter
+pileup_converter = PileUpToEDMConverter()
+pileup_converter.pileUpParticles.Path = "pileUpParticles"
+pileup_converter.GenParticles.Path = "PileUpGenParticles"
+pileup_converter.PileUpInteractions.Path = "PileUpInteractions"
+ApplicationMgr().TopAlg += [pileup_converter]
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = "output_particleGunCompactPileUp.root")
+out.outputCommands = ["keep *"]
+ApplicationMgr().TopAlg += [out]
@@ -56,6 +56,12 @@ hepmc_converter.hepmcStatusList = [] # convert particles with all statuses
 hepmc_converter.GenParticles.Path="GenParticles"
 ApplicationMgr().TopAlg += [hepmc_converter]
 
+### Summary statistics of the sample (multiplicity, charged fraction, PDG counts, cross section), in the run metadata
+from Configurables import GenSampleSummary
+summary = GenSampleSummary("GenSummary")
+summary.hepmc.Path = "hepmc"
+ApplicationMgr().TopAlg += [summary]
+
 ### Filters generated particles
 # accept is a list of particle statuses that should be accepted
 from Configurables import GenParticleFilter
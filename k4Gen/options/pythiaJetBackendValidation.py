@@ -0,0 +1,35 @@
+"""
+Pythia8 with MLM jet matching, clustering the ME/PS matching variables with both
+SlowJet and KtClustering and checking that they agree.
+
+"""
+
+import os
+from Gaudi.Configuration import *
+
+from Configurables import ApplicationMgr
+ApplicationMgr().EvtSel = 'NONE'
+ApplicationMgr().EvtMax = 20
+ApplicationMgr().OutputLevel = INFO
+ApplicationMgr().ExtSvc +=["RndmGenSvc"]
+
+#### Data service
+from Configurables import k4DataSvc
+podioevent = k4DataSvc("EventDataSvc")
+ApplicationMgr().ExtSvc += [podioevent]
+
+from Configurables import PythiaInterface
+pythia8gentool = PythiaInterface()
+# take from $K4GEN if defined, locally if not
+path_to_pythiafile = os.environ.get("K4GEN", "")
+pythia8gentool.pythiacard = os.path.join(path_to_pythiafile, "Pythia_LHEinput_Matching.cmd")
+pythia8gentool.LHEFiles = [os.path.join(path_to_pythiafile, "z012j.lhe")]
+pythia8gentool.jetBackend = "KtClustering"
+pythia8gentool.validateJetBackend = True
+pythia8gentool.doEvtGenDecays = False
+
+from Configurables import GenAlg
+pythia8gen = GenAlg("Pythia8")
+pythia8gen.SignalProvider = pythia8gentool
+pythia8gen.hepmc.Path = "hepmc"
+ApplicationMgr().TopAlg += [pythia8gen]
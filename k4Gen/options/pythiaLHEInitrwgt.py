@@ -0,0 +1,33 @@
+"""
+Pythia8 reading LHE events through the LHE prefetcher, from a file with LHEF version 3 reweighting information
+(an <initrwgt> block) in its header, which must not be taken for the <init> block.
+
+"""
+
+import os
+from Gaudi.Configuration import *
+
+from Configurables import ApplicationMgr
+ApplicationMgr().EvtSel = 'NONE'
+ApplicationMgr().EvtMax = 10
+ApplicationMgr().OutputLevel = INFO
+ApplicationMgr().ExtSvc +=["RndmGenSvc"]
+
+#### Data service
+from Configurables import k4DataSvc
+podioevent = k4DataSvc("EventDataSvc")
+ApplicationMgr().ExtSvc += [podioevent]
+
+from Configurables import PythiaInterface
+pythia8gentool = PythiaInterface()
+# take from $K4GEN if defined, locally if not
+path_to_pythiafile = os.environ.get("K4GEN", "")
+pythia8gentool.pythiacard = os.path.join(path_to_pythiafile, "Pythia_LHEinput.cmd")
+pythia8gentool.LHEFiles = ["tests/lheInitrwgtHeader.lhe"]
+pythia8gentool.doEvtGenDecays = False
+
+from Configurables import GenAlg
+pythia8gen = GenAlg("Pythia8")
+pythia8gen.SignalProvider = pythia8gentool
+pythia8gen.hepmc.Path = "hepmc"
+ApplicationMgr().TopAlg += [pythia8gen]
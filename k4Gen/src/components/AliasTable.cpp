@@ -0,0 +1,49 @@
+
+#include "AliasTable.h"
+
+#include <cmath>
+
+bool AliasTable::build(const std::vector<double>& weights) {
+  m_threshold.clear();
+  m_alias.clear();
+  m_probability.clear();
+  double sum = 0.;
+  for (double w : weights) {
+    if (!std::isfinite(w) || w < 0.)
+      return false;
+    sum += w;
+  }
+  if (weights.empty() || sum <= 0.)
+    return false;
+
+  const std::size_t n = weights.size();
+  m_probability.reserve(n);
+  m_threshold.resize(n);
+  m_alias.resize(n);
+  // columns scaled to an average height of one, split into those below and above it
+  std::vector<std::size_t> small, large;
+  for (std::size_t i = 0; i < n; ++i) {
+    m_probability.push_back(weights[i] / sum);
+    m_threshold[i] = m_probability[i] * n;
+    m_alias[i] = i;
+    (m_threshold[i] < 1. ? small : large).push_back(i);
+  }
+  // fill every small column up to one with a piece of a large one
+  while (!small.empty() && !large.empty()) {
+    const std::size_t s = small.back();
+    small.pop_back();
+    const std::size_t l = large.back();
+    m_alias[s] = l;
+    m_threshold[l] -= 1. - m_threshold[s];
+    if (m_threshold[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // what is left is one up to rounding
+  for (std::size_t i : small)
+    m_threshold[i] = 1.;
+  for (std::size_t i : large)
+    m_threshold[i] = 1.;
+  return true;
+}
@@ -0,0 +1,37 @@
+#ifndef GENERATION_ALIASTABLE_H
+#define GENERATION_ALIASTABLE_H
+
+#include <cstddef>
+#include <vector>
+
+/** @class AliasTable
+ *
+ *  Walker/Vose alias table for sampling an index from a discrete distribution in constant time, independent of the
+ *  number of entries. Building the table is O(N).
+ */
+class AliasTable {
+public:
+  /** Build the table from non-negative weights, which do not need to be normalised.
+   *  @return false if there are no weights, a weight is negative or not finite, or they sum to zero
+   */
+  bool build(const std::vector<double>& weights);
+
+  /// Index drawn with a probability proportional to its weight, from two uniform random numbers in [0, 1)
+  std::size_t sample(double u1, double u2) const {
+    std::size_t i = static_cast<std::size_t>(u1 * m_threshold.size());
+    if (i >= m_threshold.size())
+      i = m_threshold.size() - 1;
+    return u2 < m_threshold[i] ? i : m_alias[i];
+  }
+
+  std::size_t size() const { return m_probability.size(); }
+  /// Normalised probability of an index
+  double probability(std::size_t i) const { return m_probability[i]; }
+
+private:
+  /// probability to keep the index of a column instead of taking its alias
+  std::vector<double> m_threshold;
+  std::vector<std::size_t> m_alias;
+  std::vector<double> m_probability;
+};
+#endif
@@ -1,12 +1,13 @@
 #include "ConstPtParticleGun.h"
+#include "ParticleGunBatch.h"
+#include "ParticleProperties.h"
 #include "GaudiKernel/IRndmGenSvc.h"
 #include "GaudiKernel/PhysicalConstants.h"
 #include "GaudiKernel/SystemOfUnits.h"
 #include "HepMC3/GenEvent.h"
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
-#include "HepPDT/ParticleID.hh"
-#include "Pythia8/ParticleData.h"
+#include <algorithm>
 #include <cmath>
 
 DECLARE_COMPONENT(ConstPtParticleGun)
@@ -36,30 +37,50 @@ StatusCode ConstPtParticleGun::initialize() {
   }
   m_deltaPhi = m_maxPhi - m_minPhi;
   m_deltaEta = m_maxEta - m_minEta;
+  if (m_sampling == "Sobol") {
+    if (!m_importanceDensity.empty()) {
+      error() << "Sobol sampling cannot be combined with importance sampling" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_sobol = &SobolSequence::instance();
+    m_numSobolPoints = 0;
+    info() << "Sobol sampling of phi, eta and pt, starting at point " << m_samplingOffset + 1 << endmsg;
+  } else if (m_sampling != "Random") {
+    error() << "Unknown sampling " << m_sampling.value() << ", use Random or Sobol" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_importanceDensity.empty()) {
+    if (!m_ptList.empty() || !m_etaList.empty() || m_logSpacedPt) {
+      error() << "Importance sampling cannot be combined with PtList, EtaList or logSpacedPt" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (!m_importanceSampler.build(m_importancePtEdges, m_importanceEtaEdges, m_importanceDensity)) {
+      error() << "Inconsistent importance sampling binning or density" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Importance sampling of pt and eta in " << m_importanceDensity.size() << " bins, pt range "
+           << m_importancePtEdges.value().front() / Gaudi::Units::GeV << " GeV <-> "
+           << m_importancePtEdges.value().back() / Gaudi::Units::GeV << " GeV, eta range "
+           << m_importanceEtaEdges.value().front() << " <-> " << m_importanceEtaEdges.value().back() << endmsg;
+  }
   // setup particle information
   m_masses.clear();
-  auto pd = Pythia8::ParticleData();
+  const auto& particleProperties = ParticleProperties::instance();
   info() << "Particle type chosen randomly from :";
   PIDs::iterator icode;
   for (icode = m_pdgCodes.begin(); icode != m_pdgCodes.end(); ++icode) {
     info() << " " << *icode;
-    m_masses.push_back(pd.m0(*icode));
+    m_masses.push_back(particleProperties.mass(*icode) * Gaudi::Units::GeV);
   }
   info() << endmsg;
   info() << "Eta range: " << m_minEta << "  <-> " << m_maxEta << endmsg;
   info() << "Phi range: " << m_minPhi / Gaudi::Units::rad << " rad <-> " << m_maxPhi / Gaudi::Units::rad << " rad"
          << endmsg;
-  // write additional branches
+  // write additional output
   if (m_writeParticleGunBranches) {
-    m_datahandle_particlegun_pt =
-        std::make_unique<k4FWCore::DataHandle<float>>("ParticleGun_Pt", Gaudi::DataHandle::Writer, this);
-    m_datahandle_particlegun_eta =
-        std::make_unique<k4FWCore::DataHandle<float>>("ParticleGun_Eta", Gaudi::DataHandle::Writer, this);
-    m_datahandle_particlegun_costheta =
-        std::make_unique<k4FWCore::DataHandle<float>>("ParticleGun_costheta", Gaudi::DataHandle::Writer, this);
-    m_datahandle_particlegun_phi =
-        std::make_unique<k4FWCore::DataHandle<float>>("ParticleGun_Phi", Gaudi::DataHandle::Writer, this);
+    m_particleGunBranches.declare(this);
   }
+  m_buffer.clear();
   return sc;
 }
 
@@ -68,19 +89,43 @@ void ConstPtParticleGun::generateParticle(Gaudi::LorentzVector& momentum, Gaudi:
   // smearing of the vertex is done with a vertexsmeartool
   origin.SetCoordinates(0., 0., 0., 0.);
   double px(0.), py(0.), pz(0.);
-  // Generate values for eta  and phi
-  double phi = m_minPhi + m_flatGenerator() * (m_deltaPhi);
-  double eta = m_minEta + m_flatGenerator() * (m_deltaEta);
-  double pt = m_minPt + m_flatGenerator() * (m_maxPt - m_minPt);
-  if (m_logSpacedPt) {
-    pt = pow(10, std::log10(m_minPt) + (std::log10(m_maxPt) - std::log10(m_minPt)) * m_flatGenerator());
+  double phi, eta, pt;
+  if (m_sobol) {
+    // next point of the quasi-random sequence, skipping the origin
+    double u[3];
+    m_sobol->point(m_samplingOffset + ++m_numSobolPoints, 3, u);
+    phi = m_minPhi + u[0] * (m_deltaPhi);
+    eta = m_minEta + u[1] * (m_deltaEta);
+    pt = m_minPt + u[2] * (m_maxPt - m_minPt);
+    if (m_logSpacedPt) {
+      pt = pow(10, std::log10(m_minPt) + (std::log10(m_maxPt) - std::log10(m_minPt)) * u[2]);
+    }
+    if (!m_ptList.empty()) {
+      pt = m_ptList[std::min<std::size_t>(u[2] * m_ptList.size(), m_ptList.size() - 1)];
+    }
+    if (!m_etaList.empty()) {
+      eta = m_etaList[std::min<std::size_t>(u[1] * m_etaList.size(), m_etaList.size() - 1)];
+    }
+  } else {
+    // Generate values for eta  and phi
+    phi = m_minPhi + m_flatGenerator() * (m_deltaPhi);
+    eta = m_minEta + m_flatGenerator() * (m_deltaEta);
+    pt = m_minPt + m_flatGenerator() * (m_maxPt - m_minPt);
+    if (m_logSpacedPt) {
+      pt = pow(10, std::log10(m_minPt) + (std::log10(m_maxPt) - std::log10(m_minPt)) * m_flatGenerator());
+    }
+    /// if user has provided the list options, use the list
+    if (!m_ptList.empty()) {
+      pt = m_ptList[m_flatGenerator() * m_ptList.size()];
+    }
+    if (!m_etaList.empty()) {
+      eta = m_etaList[m_flatGenerator() * m_etaList.size()];
+    }
   }
-  /// if user has provided the list options, use the list
-  if (!m_ptList.empty()) {
-    pt = m_ptList[m_flatGenerator() * m_ptList.size()];
-  }
-  if (!m_etaList.empty()) {
-    eta = m_etaList[m_flatGenerator() * m_etaList.size()];
+  m_weight = 1.;
+  if (!m_importanceSampler.empty()) {
+    const double u1 = m_flatGenerator(), u2 = m_flatGenerator(), u3 = m_flatGenerator(), u4 = m_flatGenerator();
+    m_weight = m_importanceSampler.sample(u1, u2, u3, u4, pt, eta);
   }
   // Transform to x,y,z coordinates
   px = pt * cos(phi);
@@ -98,18 +143,47 @@ void ConstPtParticleGun::generateParticle(Gaudi::LorentzVector& momentum, Gaudi:
   momentum.SetE(std::sqrt(m_masses[currentType] * m_masses[currentType] + momentum.P2()));
   pdgId = m_pdgCodes[currentType];
   debug() << " -> " << pdgId << endmsg << "   P   = " << momentum << endmsg;
-  /// additional branches in rootfile
-  if (m_writeParticleGunBranches) {
-    const double hepmcMomentumConversionFactor = 0.001;
-    float* _particlegun_phi = new float(phi);
-    float* _particlegun_eta = new float(eta);
-    float* _particlegun_costheta = new float(cos(2 * atan(exp(eta))));
-    float* _particlegun_pt = new float(pt * hepmcMomentumConversionFactor);
-    m_datahandle_particlegun_pt->put(_particlegun_pt);
-    m_datahandle_particlegun_eta->put(_particlegun_eta);
-    m_datahandle_particlegun_costheta->put(_particlegun_costheta);
-    m_datahandle_particlegun_phi->put(_particlegun_phi);
+}
+
+/// Generate a batch of particles
+void ConstPtParticleGun::generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                           std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds) {
+  if (!m_importanceSampler.empty() || m_sobol) {
+    // the sequence is followed particle by particle, and the weights of importance-sampled particles are only kept
+    // in the events of getNextEvent
+    momenta.resize(n);
+    origins.resize(n);
+    pdgIds.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+      generateParticle(momenta[i], origins[i], pdgIds[i]);
+    return;
   }
+  // smearing of the vertex is done with a vertexsmeartool
+  origins.assign(n, Gaudi::LorentzVector(0., 0., 0., 0.));
+  // one block of uniform numbers for phi, eta, pt and the particle type
+  m_flatGenerator.shootArray(m_uniforms, 4 * n).ignore();
+  double* phi = m_uniforms.data();
+  double* eta = phi + n;
+  double* pt = eta + n;
+  const double* type = pt + n;
+  ParticleGunBatch::flat(phi, n, m_minPhi, m_deltaPhi);
+  /// if user has provided the list options, use the list
+  if (!m_etaList.empty())
+    ParticleGunBatch::fromList(eta, n, m_etaList);
+  else
+    ParticleGunBatch::flat(eta, n, m_minEta, m_deltaEta);
+  if (!m_ptList.empty())
+    ParticleGunBatch::fromList(pt, n, m_ptList);
+  else if (m_logSpacedPt)
+    ParticleGunBatch::logFlat(pt, n, m_minPt, m_maxPt);
+  else
+    ParticleGunBatch::flat(pt, n, m_minPt, m_maxPt - m_minPt);
+  // masses and the cartesian components
+  m_scratch.resize(5 * n);
+  double* mass = m_scratch.data();
+  ParticleGunBatch::particleTypes(type, n, m_pdgCodes, m_masses, pdgIds, mass);
+  ParticleGunBatch::momentaFromPtEtaPhi(n, pt, eta, phi, mass, mass + n, mass + 2 * n, mass + 3 * n, mass + 4 * n,
+                                        momenta);
 }
 
 StatusCode ConstPtParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
@@ -117,7 +191,19 @@ StatusCode ConstPtParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
   Gaudi::LorentzVector origin;
   // note: pgdid is set in function generateParticle
   int thePdgId;
-  generateParticle(theFourMomentum, origin, thePdgId);
+  if (m_batchSize > 1 && m_importanceSampler.empty() && !m_sobol) {
+    if (m_buffer.empty()) {
+      generateParticles(m_batchSize, m_buffer.momenta, m_buffer.origins, m_buffer.pdgIds);
+      m_buffer.next = 0;
+    }
+    m_buffer.pop(theFourMomentum, origin, thePdgId);
+  } else {
+    generateParticle(theFourMomentum, origin, thePdgId);
+  }
+  /// additional output in rootfile
+  if (m_writeParticleGunBranches) {
+    m_particleGunBranches.fill(&theFourMomentum, 1, m_minPhi);
+  }
 
   // create HepMC Vertex --
   // by calling add_vertex(), the hepmc event is given ownership of the vertex
@@ -136,6 +222,12 @@ StatusCode ConstPtParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
                                             1); // hepmc status code for final state particle
   v->add_particle_out(p);
   theEvent.add_vertex(v);
+  if (!m_importanceSampler.empty()) {
+    if (theEvent.weights().empty())
+      theEvent.weights().push_back(m_weight);
+    else
+      theEvent.weights()[0] *= m_weight;
+  }
   // no longer needed in hepmc3?
   // theEvent.set_signal_process_vertex(v);
   return StatusCode::SUCCESS;
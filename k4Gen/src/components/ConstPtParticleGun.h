@@ -8,11 +8,18 @@
 #include "Generation/IParticleGunTool.h"
 #include "k4FWCore/DataHandle.h"
 
+#include "ImportanceSampler2D.h"
+#include "ParticleGunBatch.h"
+#include "SobolSequence.h"
+
 /** @class ConstPtParticleGun
  *
  *  Particle gun, that, given a list of pt's  and an eta range, creates the desired four-momenta.
  *  To be more flexible, the gun uses only pt and eta values from a list, if given,
  *  and only if the lists are empty draws the values from a distribution between min and max.
+ *  With sampling = "Sobol", phi, eta and pt are taken from a low-discrepancy sequence instead of pseudo-random numbers.
+ *  With importanceDensity, pt and eta are instead drawn from a binned density, and the weight of the particle is stored
+ *  as event weight, to cover some regions with more events than others.
  */
 class ConstPtParticleGun : public AlgTool, virtual public IParticleGunTool {
 public:
@@ -21,6 +28,9 @@ public:
   virtual StatusCode initialize();
   /// Generation of particles
   virtual void generateParticle(Gaudi::LorentzVector& momentum, Gaudi::LorentzVector& origin, int& pdgId);
+  /// Generation of a batch of particles
+  virtual void generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds);
   virtual void printCounters() { ; };
   virtual StatusCode getNextEvent(HepMC3::GenEvent&);
 
@@ -50,13 +60,32 @@ private:
   Gaudi::Property<double> m_maxPhi{this, "PhiMax", Gaudi::Units::twopi* Gaudi::Units::rad,
                                    "Upper limit for the azimuth distribution of generated particles"};
   Gaudi::Property<std::vector<int>> m_pdgCodes{this, "PdgCodes", {-211}, "List of PDG codes to produce."};
+  Gaudi::Property<std::string> m_sampling{
+      this, "sampling", "Random",
+      "Sampling of phi, eta and pt: Random, or Sobol for a quasi-random sequence that covers them more evenly"};
+  Gaudi::Property<unsigned long> m_samplingOffset{
+      this, "samplingOffset", 0,
+      "Index of the first Sobol point used by this job, e.g. job index times events per job, so that jobs use "
+      "disjoint parts of the sequence"};
+  Gaudi::Property<std::vector<double>> m_importancePtEdges{
+      this, "importancePtEdges", {}, "Bin edges in pt of the importance sampling density"};
+  Gaudi::Property<std::vector<double>> m_importanceEtaEdges{
+      this, "importanceEtaEdges", {}, "Bin edges in eta of the importance sampling density"};
+  Gaudi::Property<std::vector<double>> m_importanceDensity{
+      this,
+      "importanceDensity",
+      {},
+      "Relative density in every pt and eta bin (index iPt * number of eta bins + iEta). If given, pt and eta are "
+      "drawn from it instead of flat, and the event gets the weight that restores a flat distribution"};
+  Gaudi::Property<unsigned int> m_batchSize{
+      this, "batchSize", 1,
+      "Number of particles generated ahead in one batch and served one per event; 1 generates every particle on its "
+      "own. Not used with importance sampling or Sobol sampling"};
   Gaudi::Property<bool> m_writeParticleGunBranches{
-      this, "writeParticleGunBranches", {true}, "Write additional Branches with Particle Properties (eta, pt)"};
-  /// optional additional branches (switched on by  m_writeParticleGunBranches)
-  std::unique_ptr<k4FWCore::DataHandle<float>> m_datahandle_particlegun_pt;
-  std::unique_ptr<k4FWCore::DataHandle<float>> m_datahandle_particlegun_eta;
-  std::unique_ptr<k4FWCore::DataHandle<float>> m_datahandle_particlegun_costheta;
-  std::unique_ptr<k4FWCore::DataHandle<float>> m_datahandle_particlegun_phi;
+      this, "writeParticleGunBranches", {true},
+      "Write the generated pt, eta, cos(theta) and phi to the ParticleGun_* outputs"};
+  /// optional additional output with pt, eta, cos(theta) and phi (switched on by  m_writeParticleGunBranches)
+  ParticleGunBatch::Branches m_particleGunBranches;
 
   /// helper variables
   double m_deltaEta;
@@ -67,6 +96,17 @@ private:
   std::vector<std::string> m_names;
   /// Flat random number generator
   Rndm::Numbers m_flatGenerator;
+  /// Quasi-random sampling, and the number of points used so far
+  const SobolSequence* m_sobol{nullptr};
+  unsigned long m_numSobolPoints{0};
+  /// Importance sampling of pt and eta, and the weight of the last generated particle
+  ImportanceSampler2D m_importanceSampler;
+  double m_weight{1.};
+  /// Uniform random numbers and scratch space of the batch generation, reused between batches
+  std::vector<double> m_uniforms;
+  std::vector<double> m_scratch;
+  /// Particles generated ahead for getNextEvent
+  ParticleGunBatch::Buffer m_buffer;
 };
 
 #endif // GENERATION_CONSTPTPARTICLEGUN_H
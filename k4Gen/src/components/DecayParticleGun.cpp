@@ -0,0 +1,111 @@
+#include "DecayParticleGun.h"
+#include "EvtGenSetup.h"
+
+#include "GaudiKernel/IIncidentSvc.h"
+#include "GaudiKernel/Incident.h"
+#include "GaudiKernel/System.h"
+
+#include "HepMC3/GenEvent.h"
+#include "Pythia8/Pythia.h"
+#include "Pythia8Plugins/EvtGen.h"
+
+DECLARE_COMPONENT(DecayParticleGun)
+
+DecayParticleGun::DecayParticleGun(const std::string& type, const std::string& name, const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<IHepMCProviderTool>(this);
+  declareProperty("ParticleGunTool", m_particleGun, "Particle gun providing the particles to decay");
+}
+
+DecayParticleGun::~DecayParticleGun() {}
+
+StatusCode DecayParticleGun::initialize() {
+  StatusCode sc = AlgTool::initialize();
+  if (!sc.isSuccess())
+    return sc;
+  if (!m_particleGun.retrieve()) {
+    error() << "Particle gun tool is missing!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+
+  // Set Pythia configuration directory from system variable (if set)
+  std::string xmlpath = "";
+  if (System::getEnv("PYTHIA8_XML") != "UNKNOWN")
+    xmlpath = System::getEnv("PYTHIA8_XML");
+  m_pythia = std::make_unique<Pythia8::Pythia>(xmlpath);
+  // only the decays of the particles put into the event record are run
+  m_pythia->readString("ProcessLevel:all = off");
+  m_pythia->readString("Next:numberCount = 0");
+  for (const auto& setting : m_pythiaExtraSettings) {
+    if (!m_pythia->readString(setting)) {
+      error() << "Cannot read Pythia8 setting " << setting << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_maxAborts = m_pythia->settings.mode("Main:timesAllowErrors");
+
+  // Set up evtGen
+  if (m_doEvtGenDecays) {
+    m_evtgen = EvtGenSetup::makeEvtGenDecays(m_pythia.get(), m_EvtGenDecayFile, m_EvtGenParticleDataFile,
+                                             m_UserDecayFile, m_evtGenExcludes);
+  }
+
+  if (!m_pythia->init()) {
+    error() << "Cannot initialize Pythia8 for the decays" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode DecayParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
+  // the gun event, with its batching and its weight, is filled in GeV and mm like the Pythia8 event record
+  HepMC3::GenEvent gunEvent(HepMC3::Units::GEV, HepMC3::Units::MM);
+  StatusCode sc = m_particleGun->getNextEvent(gunEvent);
+  if (!sc.isSuccess())
+    return sc;
+
+  // Decay the gun particles. Quit if many failures in a row
+  int nAborts = 0;
+  while (true) {
+    Pythia8::Event& event = m_pythia->event;
+    event.reset();
+    for (const auto& particle : gunEvent.particles()) {
+      const auto& momentum = particle->momentum();
+      const int i = event.append(particle->pid(), 1, 0, 0, momentum.px(), momentum.py(), momentum.pz(), momentum.e(),
+                                 momentum.m());
+      if (particle->production_vertex()) {
+        const auto& position = particle->production_vertex()->position();
+        event[i].vProd(position.x(), position.y(), position.z(), position.t());
+      }
+    }
+    if (m_pythia->next())
+      break;
+    if (++nAborts > m_maxAborts) {
+      IIncidentSvc* incidentSvc;
+      incidentSvc = service<IIncidentSvc>("IncidentSvc", false);
+      incidentSvc->fireIncident(Incident(name(), IncidentType::AbortEvent));
+      error() << "Decay of the gun particles failed too often!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    warning() << "DecayParticleGun Pythia8 abort : " << nAborts << "/" << m_maxAborts << endmsg;
+  }
+  if (m_evtgen) {
+    m_evtgen->decay();
+  }
+
+  m_pythiaToHepMC.fill_next_event(*m_pythia, theEvent);
+  // keep the weight of the gun, e.g. from importance sampling
+  if (!gunEvent.weights().empty()) {
+    if (theEvent.weights().empty())
+      theEvent.weights().push_back(gunEvent.weight());
+    else
+      theEvent.weights()[0] *= gunEvent.weight();
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode DecayParticleGun::finalize() {
+  m_evtgen.reset();
+  m_pythia.reset();
+  return AlgTool::finalize();
+}
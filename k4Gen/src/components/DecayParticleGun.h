@@ -0,0 +1,58 @@
+#ifndef GENERATION_DECAYPARTICLEGUN_H
+#define GENERATION_DECAYPARTICLEGUN_H
+
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/ToolHandle.h"
+#include "Generation/IHepMCProviderTool.h"
+#include "Generation/IParticleGunTool.h"
+#include "Pythia8Plugins/HepMC3.h"
+
+#include <memory>
+
+namespace Pythia8 {
+class EvtGenDecays;
+class Pythia;
+} // namespace Pythia8
+
+/** @class DecayParticleGun
+ *
+ *  Provides the events of a particle gun tool with their particles decayed by Pythia8 or EvtGen. One Pythia8
+ *  instance is set up at initialization with the process and parton levels switched off, so that every event only
+ *  runs the decays of the gun particles, e.g. for B-hadron or tau samples at gun speed instead of running a full
+ *  generator. The weight of the gun event is kept. The EvtGen configuration is the same as in PythiaInterface.
+ */
+class DecayParticleGun : public AlgTool, virtual public IHepMCProviderTool {
+public:
+  DecayParticleGun(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~DecayParticleGun();
+  virtual StatusCode initialize();
+  virtual StatusCode finalize();
+  virtual StatusCode getNextEvent(HepMC3::GenEvent& theEvent);
+
+private:
+  /// Gun providing the particle to decay
+  ToolHandle<IParticleGunTool> m_particleGun{"MomentumRangeParticleGun/ParticleGun", this};
+
+  /// Settings of the decays, e.g. particle data changes or forced decay channels
+  Gaudi::Property<std::vector<std::string>> m_pythiaExtraSettings{
+      this, "pythiaExtraSettings", {}, "Additional Pythia8 settings, e.g. for the decays"};
+
+  Gaudi::Property<bool> m_doEvtGenDecays{this, "doEvtGenDecays", false, "Do decays with EvtGen"};
+  Gaudi::Property<std::string> m_EvtGenDecayFile{this, "EvtGenDecayFile", "Generation/data/DECAY.DEC",
+                                                 "Name of the global EvtGen Decay File"};
+  Gaudi::Property<std::string> m_UserDecayFile{this, "UserDecayFile", "", "Name of the  EvtGen User Decay File"};
+  Gaudi::Property<std::string> m_EvtGenParticleDataFile{this, "EvtGenParticleDataFile", "Generation/data/evt.pdl",
+                                                        "Name of the EvtGen Particle Data File"};
+  Gaudi::Property<std::vector<int>> m_evtGenExcludes{
+      this, "EvtGenExcludes", {}, "PDG IDs of particles not to decay with EvtGen"};
+
+  /// Pythia8 engine, only used for the decays
+  std::unique_ptr<Pythia8::Pythia> m_pythia;
+  std::unique_ptr<Pythia8::EvtGenDecays> m_evtgen;
+  /// Interface for conversion from Pythia8::Event to HepMC event.
+  HepMC3::Pythia8ToHepMC3 m_pythiaToHepMC;
+  /// how many failed decays in a row before the run stops
+  int m_maxAborts{0};
+};
+
+#endif // GENERATION_DECAYPARTICLEGUN_H
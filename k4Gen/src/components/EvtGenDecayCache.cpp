@@ -0,0 +1,149 @@
+#include "EvtGenDecayCache.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace {
+/// Non-comment, non-empty lines of an EvtGen decay file, with the first three tokens of each line
+struct DecayFileLine {
+  std::string text;
+  std::string keyword;
+  std::string argument;
+  std::string secondArgument;
+};
+
+std::vector<DecayFileLine> decayFileLines(const std::string& content) {
+  std::vector<DecayFileLine> lines;
+  std::istringstream input(content);
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream tokens(line);
+    DecayFileLine decayLine;
+    tokens >> decayLine.keyword >> decayLine.argument >> decayLine.secondArgument;
+    if (decayLine.keyword.empty() || decayLine.keyword[0] == '#')
+      continue;
+    decayLine.text = line;
+    lines.push_back(decayLine);
+  }
+  return lines;
+}
+
+/// Charge conjugates by particle name, from the particle data and the ChargeConj lines of the decay files
+class ChargeConjugates {
+public:
+  explicit ChargeConjugates(const std::string& particleData) {
+    std::istringstream input(particleData);
+    std::string line;
+    while (std::getline(input, line)) {
+      // add  p Particle  <name>  <PDG code>  ...
+      std::istringstream tokens(line);
+      std::string add, type, kind, name;
+      int pdgId;
+      if (tokens >> add >> type >> kind >> name >> pdgId && add == "add") {
+        m_pdgIds[name] = pdgId;
+        m_names[pdgId] = name;
+      }
+    }
+  }
+  void addChargeConj(const std::string& a, const std::string& b) {
+    m_chargeConj[a] = b;
+    m_chargeConj[b] = a;
+  }
+  /// Name of the charge conjugate, empty if it is unknown
+  std::string conjugate(const std::string& name) const {
+    auto chargeConj = m_chargeConj.find(name);
+    if (chargeConj != m_chargeConj.end())
+      return chargeConj->second;
+    auto pdgId = m_pdgIds.find(name);
+    if (pdgId == m_pdgIds.end())
+      return "";
+    // as in EvtGen, a particle without an antiparticle in the table is its own conjugate
+    auto anti = m_names.find(-pdgId->second);
+    return anti == m_names.end() ? name : anti->second;
+  }
+
+private:
+  std::map<std::string, int> m_pdgIds;
+  std::map<int, std::string> m_names;
+  std::map<std::string, std::string> m_chargeConj;
+};
+} // namespace
+
+namespace EvtGenDecayCache {
+
+std::string mergeDecayFiles(const std::string& globalDecays, const std::string& userDecays,
+                            const std::string& particleData) {
+  // Lines of the global file up to its End, EvtGen ignores the rest
+  std::vector<DecayFileLine> globalLines;
+  for (const auto& line : decayFileLines(globalDecays)) {
+    if (line.keyword == "End")
+      break;
+    globalLines.push_back(line);
+  }
+  std::vector<DecayFileLine> userLines;
+  for (const auto& line : decayFileLines(userDecays)) {
+    if (line.keyword == "End")
+      break;
+    userLines.push_back(line);
+  }
+
+  ChargeConjugates conjugates(particleData);
+  for (const auto* lines : {&globalLines, &userLines}) {
+    for (const auto& line : *lines) {
+      if (line.keyword == "ChargeConj")
+        conjugates.addChargeConj(line.argument, line.secondArgument);
+    }
+  }
+
+  // Particles whose decays are redefined in the user file
+  std::set<std::string> redefined;
+  for (const auto& line : userLines) {
+    if (line.keyword == "Decay" || line.keyword == "CDecay") {
+      redefined.insert(line.argument);
+    }
+  }
+
+  // Redefined particles whose global decays are still needed, as the source of a global CDecay that is kept.
+  // A kept global CDecay of a redefined particle can in turn need its own source.
+  std::set<std::string> kept;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto& line : globalLines) {
+      if (line.keyword != "CDecay" || (redefined.count(line.argument) && !kept.count(line.argument)))
+        continue;
+      const std::string source = conjugates.conjugate(line.argument);
+      if (source.empty())
+        return "";
+      if (redefined.count(source) && kept.insert(source).second)
+        changed = true;
+    }
+  }
+
+  // Merge both files into one table without comments, dropping the redefined decays from the global one
+  std::ostringstream merged;
+  bool skipDecay = false;
+  for (const auto& line : globalLines) {
+    if (skipDecay) {
+      skipDecay = line.keyword != "Enddecay";
+      continue;
+    }
+    const bool dropped = redefined.count(line.argument) && !kept.count(line.argument);
+    if (line.keyword == "Decay" && dropped) {
+      skipDecay = true;
+      continue;
+    }
+    if (line.keyword == "CDecay" && dropped)
+      continue;
+    merged << line.text << '\n';
+  }
+  for (const auto& line : userLines) {
+    merged << line.text << '\n';
+  }
+  merged << "End\n";
+  return merged.str();
+}
+
+} // namespace EvtGenDecayCache
@@ -0,0 +1,28 @@
+#ifndef GENERATION_EVTGENDECAYCACHE_H
+#define GENERATION_EVTGENDECAYCACHE_H
+
+#include <string>
+
+/** @file EvtGenDecayCache.h
+ *
+ *  Merging of the global and user EvtGen decay files into one self-contained table, which gives the same decays as
+ *  reading the two files one after the other. EvtGen still parses the whole table, so it is not read faster.
+ */
+namespace EvtGenDecayCache {
+
+/** Merge the contents of the global and user decay files.
+ *  The global decays that are redefined in the user file are dropped, unless a charge conjugate decay of the global
+ *  file is derived from them with CDecay: EvtGen resolves CDecay when it reads the line, so these global decays are
+ *  kept and overridden by the user decays later in the table, as when reading the files one after the other.
+ *  Comments and everything after the End of the global file are left out.
+ *  @param[in] globalDecays  content of the global decay file
+ *  @param[in] userDecays    content of the user decay file, may be empty
+ *  @param[in] particleData  content of the EvtGen particle data (evt.pdl) file, used to find the charge conjugates
+ *  @return the merged table, empty if the charge conjugate of a particle used with CDecay cannot be found
+ */
+std::string mergeDecayFiles(const std::string& globalDecays, const std::string& userDecays,
+                            const std::string& particleData);
+
+} // namespace EvtGenDecayCache
+
+#endif // GENERATION_EVTGENDECAYCACHE_H
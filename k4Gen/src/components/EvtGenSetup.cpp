@@ -0,0 +1,34 @@
+#include "EvtGenSetup.h"
+
+#include "Pythia8/Pythia.h"
+#include "Pythia8Plugins/EvtGen.h"
+
+namespace EvtGenSetup {
+
+std::unique_ptr<Pythia8::EvtGenDecays> makeEvtGenDecays(Pythia8::Pythia* pythia, const std::string& decayFile,
+                                                        const std::string& particleDataFile,
+                                                        const std::string& userDecayFile,
+                                                        const std::vector<int>& excludes) {
+  auto evtgen = std::make_unique<Pythia8::EvtGenDecays>(
+      pythia,           // the pythia instance
+      decayFile,        // the file name of the evtgen decay file
+      particleDataFile, // the file name of the evtgen data file
+      nullptr, // the optional EvtExternalGenList pointer (must be provided if the next argument is provided to avoid
+               // double initializations)
+      nullptr, // the EvtAbsRadCorr pointer to pass to EvtGen
+      1,       // the mixing type to pass to EvtGen
+      false,   // a flag to use XML files to pass to EvtGen
+      true,    // a flag to limit decays based on the Pythia criteria (based on the particle decay vertex)
+      true,    // a flag to use external models with EvtGen
+      false);  // a flag if an FSR model should be passed to EvtGen (pay attention to this, default is true)
+  if (!userDecayFile.empty()) {
+    evtgen->readDecayFile(userDecayFile);
+  }
+  // Possibility to force Pythia8 to do decays
+  for (auto _pdgid : excludes) {
+    evtgen->exclude(_pdgid);
+  }
+  return evtgen;
+}
+
+} // namespace EvtGenSetup
@@ -0,0 +1,33 @@
+#ifndef GENERATION_EVTGENSETUP_H
+#define GENERATION_EVTGENSETUP_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Pythia8 {
+class EvtGenDecays;
+class Pythia;
+} // namespace Pythia8
+
+/** @file EvtGenSetup.h
+ *
+ *  Setup of the EvtGen decays of a Pythia8 instance, shared by the tools that decay with EvtGen.
+ */
+namespace EvtGenSetup {
+
+/** Create the EvtGen decays for a Pythia8 instance, before Pythia8::Pythia::init() is called.
+ *  @param[in] pythia            the Pythia8 instance whose decays are done by EvtGen
+ *  @param[in] decayFile         the global EvtGen decay file
+ *  @param[in] particleDataFile  the EvtGen particle data file
+ *  @param[in] userDecayFile     the user decay file read after the global one, not read if empty
+ *  @param[in] excludes          PDG IDs of particles left to Pythia8 to decay
+ */
+std::unique_ptr<Pythia8::EvtGenDecays> makeEvtGenDecays(Pythia8::Pythia* pythia, const std::string& decayFile,
+                                                        const std::string& particleDataFile,
+                                                        const std::string& userDecayFile,
+                                                        const std::vector<int>& excludes);
+
+} // namespace EvtGenSetup
+
+#endif // GENERATION_EVTGENSETUP_H
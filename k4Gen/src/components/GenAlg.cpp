@@ -7,6 +7,10 @@
 
 // HepMC3
 #include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+#include "Generation/PileUpInteractionRanges.h"
 
 DECLARE_COMPONENT(GenAlg)
 
@@ -17,6 +21,7 @@ GenAlg::GenAlg(const std::string& name, ISvcLocator* svcLoc) : Gaudi::Algorithm(
   declareProperty("VertexSmearingTool", m_vertexSmearingTool, "Vertex smearing tool");
   declareProperty("HepMCMergeTool", m_hepmcMergeTool, "Event merge tool");
   declareProperty("hepmc", m_hepmcHandle, "HepMC event handle (output)");
+  declareProperty("pileUpParticles", m_pileUpHandle, "Compact pileup particles (output, with compactPileUp)");
 }
 
 StatusCode GenAlg::initialize() {
@@ -51,54 +56,109 @@ StatusCode GenAlg::initialize() {
     return StatusCode::FAILURE;
   }
 
+  m_timeStages = m_monitorStages || !m_stageSummaryFile.empty();
+  if (m_monitorMemory) {
+    m_allocationHook = AllocationHook::find();
+    if (nullptr == m_allocationHook)
+      warning() << "Allocation hook not preloaded, only the peak RSS is monitored. Run with "
+                << "LD_PRELOAD=libk4GenAllocationHook.so to count the allocations per stage." << endmsg;
+  }
+
   return StatusCode::SUCCESS;
 }
 
 StatusCode GenAlg::execute(const EventContext&) const {
+  StageTimer totalTimer(m_timeTotal, m_timeStages);
+
   // Create empty event
   HepMC3::GenEvent* theEvent = m_hepmcHandle.createAndPut();
   theEvent->set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
 
   // Get the event from the signal provider
   {
+    StageTimer timer(m_timeSignal, m_timeStages);
     StatusCode sc = m_signalProvider->getNextEvent(*theEvent);
-    if (!sc.isSuccess())
+    if (!sc.isSuccess()) {
+      ++m_numAborts;
       return sc;
+    }
   }
 
   // Smear vertex
   {
+    StageTimer timer(m_timeSmearing, m_timeStages);
     StatusCode sc = m_vertexSmearingTool->smearVertex(*theEvent);
-    if (!sc.isSuccess())
+    if (!sc.isSuccess()) {
+      ++m_numAborts;
       return sc;
+    }
   }
 
   // Get number of pileup events
   const unsigned int numPileUp = m_pileUpTool->numberOfPileUp();
   debug() << "Number of pileup events: " << numPileUp << endmsg;
-
-  // Merge in pileup
-  if (numPileUp > 0) {
-    std::vector<HepMC3::GenEvent> eventVector;
-    eventVector.reserve(numPileUp + 1);
-
-    if (!m_pileUpProvider.empty()) {
-      for (unsigned int i_pileUp = 0; i_pileUp < numPileUp; ++i_pileUp) {
-        auto puEvt = HepMC3::GenEvent();
+  m_numPileUp += numPileUp;
+
+  PileUpParticles* pileUpParticles = nullptr;
+  if (m_compactPileUp)
+    pileUpParticles = m_pileUpHandle.createAndPut();
+
+  // Generate, smear and merge the pileup events one at a time, so that only one of them is in memory
+  PileUpInteractionRanges::Collector interactions;
+  if (numPileUp > 0 && !m_pileUpProvider.empty()) {
+    double pileUpTime = 0., mergeTime = 0.;
+    StageMemoryTotals pileUpMemory, mergeMemory;
+    for (unsigned int i_pileUp = 0; i_pileUp < numPileUp; ++i_pileUp) {
+      auto puEvt = HepMC3::GenEvent();
+      {
+        StageTimer timer(pileUpTime, m_timeStages);
+        StageMemory memory(pileUpMemory, m_allocationHook);
         StatusCode sc = m_pileUpProvider->getNextEvent(puEvt);
-        if (!sc.isSuccess())
+        if (!sc.isSuccess()) {
+          ++m_numAborts;
           return sc;
+        }
 
         m_vertexSmearingTool->smearVertex(puEvt).ignore();
-        eventVector.push_back(std::move(puEvt));
       }
+      // an empty pileup event is still merged as an interaction without particles, so that pileup event i_pileUp is
+      // always interaction i_pileUp, in the ranges and in the compact pileup
+      if (puEvt.particles().empty())
+        ++m_numEmptyPileUp;
+
+      StageTimer timer(mergeTime, m_timeStages);
+      StageMemory memory(mergeMemory, m_allocationHook);
+      if (pileUpParticles) {
+        appendCompactPileUp(puEvt, i_pileUp, *pileUpParticles);
+        continue;
+      }
+      const int firstParticle = theEvent->particles().size();
+      const int firstVertex = theEvent->vertices().size();
+      StatusCode sc = m_hepmcMergeTool->merge(*theEvent, std::move(puEvt));
+      if (!sc.isSuccess()) {
+        ++m_numAborts;
+        return sc;
+      }
+      interactions.add(*theEvent, firstParticle, firstVertex);
+    }
+    if (m_timeStages) {
+      m_timePileUp += pileUpTime;
+      m_timeMerge += mergeTime;
+    }
+    if (m_allocationHook) {
+      m_memoryPileUp.fill(pileUpMemory);
+      m_memoryMerge.fill(mergeMemory);
     }
-
-    StatusCode sc = m_hepmcMergeTool->merge(*theEvent, eventVector);
-    if (!sc.isSuccess())
-      return sc;
   }
 
+  // the ranges are stored whenever pileup is merged, also for events without pileup, so that every event has them
+  if (!m_pileUpProvider.empty() && !pileUpParticles)
+    interactions.store(*theEvent);
+
+  m_numParticles += theEvent->particles().size();
+  m_numVertices += theEvent->vertices().size();
+  if (m_monitorMemory)
+    m_peakRss += peakRssMB();
   debug() << "Event number: " << theEvent->event_number() << endmsg;
   debug() << "Number of particles in the event: " << theEvent->particles().size() << endmsg;
   debug() << "Number of vertices in the event: " << theEvent->vertices().size() << endmsg;
@@ -106,4 +166,40 @@ StatusCode GenAlg::execute(const EventContext&) const {
   return StatusCode::SUCCESS;
 }
 
-StatusCode GenAlg::finalize() { return Gaudi::Algorithm::finalize(); }
+void GenAlg::appendCompactPileUp(const HepMC3::GenEvent& pileUpEvent, unsigned int interaction,
+                                 PileUpParticles& pileUpParticles) const {
+  // same selection of final-state particles as HepMCSimpleMerge
+  for (const auto& p : pileUpEvent.particles()) {
+    if (p->end_vertex() || p->status() != 1)
+      continue;
+    const auto& momentum = p->momentum();
+    const auto prodVertex = p->production_vertex();
+    const HepMC3::FourVector position = prodVertex ? prodVertex->position() : HepMC3::FourVector();
+    pileUpParticles.push_back(momentum.px(), momentum.py(), momentum.pz(), momentum.e(), p->generated_mass(),
+                              p->pdg_id(), p->status(), position.x(), position.y(), position.z(), position.t(),
+                              interaction);
+  }
+}
+
+StatusCode GenAlg::finalize() {
+  if (!m_stageSummaryFile.empty()) {
+    StageCounters counters{{"time total [ms]", &m_timeTotal},
+                           {"time signal [ms]", &m_timeSignal},
+                           {"time vertex smearing [ms]", &m_timeSmearing},
+                           {"time pileup generation [ms]", &m_timePileUp},
+                           {"time merge [ms]", &m_timeMerge},
+                           {"pileup events", &m_numPileUp},
+                           {"particles", &m_numParticles},
+                           {"vertices", &m_numVertices}};
+    if (m_monitorMemory) {
+      m_memoryPileUp.addTo(counters);
+      m_memoryMerge.addTo(counters);
+      counters.emplace_back("peak RSS [MB]", &m_peakRss);
+    }
+    const StageCounts counts{{"aborts", m_numAborts.nEntries()},
+                             {"empty pileup events", m_numEmptyPileUp.nEntries()}};
+    if (!writeStageSummary(m_stageSummaryFile, name(), m_timeTotal, counters, counts))
+      warning() << "Could not write the stage summary to " << m_stageSummaryFile.value() << endmsg;
+  }
+  return Gaudi::Algorithm::finalize();
+}
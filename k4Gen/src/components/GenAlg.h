@@ -13,6 +13,10 @@
 #include "Generation/IHepMCProviderTool.h"
 #include "Generation/IPileUpTool.h"
 #include "Generation/IVertexSmearingTool.h"
+#include "Generation/PileUpParticles.h"
+
+#include "MemoryMonitor.h"
+#include "StageMonitor.h"
 
 namespace HepMC3 {
 class GenEvent;
@@ -43,6 +47,46 @@ private:
   mutable ToolHandle<IHepMCMergeTool> m_hepmcMergeTool{"HepMCSimpleMerge/HepMCMergeTool", this};
   // Output handle for finished event
   mutable k4FWCore::DataHandle<HepMC3::GenEvent> m_hepmcHandle{"hepmc", Gaudi::DataHandle::Writer, this};
+
+  /// Switch to store the pileup final-state particles in a compact side product instead of merging them
+  Gaudi::Property<bool> m_compactPileUp{
+      this, "compactPileUp", false,
+      "Write the final-state pileup particles to the compact pileUpParticles output instead of merging them into the "
+      "signal HepMC event"};
+  // Output handle for the compact pileup particles
+  mutable k4FWCore::DataHandle<PileUpParticles> m_pileUpHandle{"pileUpParticles", Gaudi::DataHandle::Writer, this};
+  /// Append the final-state particles of a pileup event to the compact pileup output
+  void appendCompactPileUp(const HepMC3::GenEvent& pileUpEvent, unsigned int interaction,
+                           PileUpParticles& pileUpParticles) const;
+
+  /// Switch for the per-stage timers
+  Gaudi::Property<bool> m_monitorStages{this, "monitorStages", false, "Time the generation stages of every event"};
+  /// JSON summary of the stage timers and counters written at finalize, enables the timers
+  Gaudi::Property<std::string> m_stageSummaryFile{this, "stageSummaryFile", "",
+                                                  "File for a JSON summary of the stage timers and counters"};
+  bool m_timeStages{false};
+
+  // Stage timers [ms] and per-event counters
+  mutable Gaudi::Accumulators::StatCounter<double> m_timeTotal{this, "time total [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_timeSignal{this, "time signal [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_timeSmearing{this, "time vertex smearing [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_timePileUp{this, "time pileup generation [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_timeMerge{this, "time merge [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numPileUp{this, "pileup events"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numParticles{this, "particles"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numVertices{this, "vertices"};
+  mutable Gaudi::Accumulators::Counter<> m_numAborts{this, "aborts"};
+  /// pileup events without particles, which are merged as empty interactions
+  mutable Gaudi::Accumulators::Counter<> m_numEmptyPileUp{this, "empty pileup events"};
+
+  /// Switch for the allocation counters per stage, which need the preloaded allocation hook, and the peak RSS
+  Gaudi::Property<bool> m_monitorMemory{this, "monitorMemory", false,
+                                        "Count allocations and heap peak per stage (needs LD_PRELOAD of "
+                                        "libk4GenAllocationHook.so) and record the peak RSS of every event"};
+  const AllocationHook* m_allocationHook{nullptr};
+  mutable StageMemoryCounters m_memoryPileUp{this, "pileup generation"};
+  mutable StageMemoryCounters m_memoryMerge{this, "merge"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_peakRss{this, "peak RSS [MB]"};
 };
 
 #endif // GENERATION_GENALG_H
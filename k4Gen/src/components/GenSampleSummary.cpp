@@ -0,0 +1,127 @@
+#include "GenSampleSummary.h"
+
+#include "HepMC3/GenCrossSection.h"
+#include "HepMC3/GenParticle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "ParticleProperties.h"
+
+DECLARE_COMPONENT(GenSampleSummary)
+
+namespace {
+std::atomic<unsigned long> nextInstanceId{0};
+}
+
+GenSampleSummary::GenSampleSummary(const std::string& name, ISvcLocator* svcLoc) : Gaudi::Algorithm(name, svcLoc) {
+  declareProperty("hepmc", m_hepmchandle, "The HepMC event to summarize (input)");
+  declareProperty("GenParticles", m_genphandle, "The EDM4hep particles to summarize (input)");
+}
+
+StatusCode GenSampleSummary::initialize() {
+  if (Gaudi::Algorithm::initialize().isFailure())
+    return StatusCode::FAILURE;
+
+  if (m_inputType.value() != "HepMC" && m_inputType.value() != "EDM4hep") {
+    error() << "Unknown inputType " << m_inputType.value() << ", use HepMC or EDM4hep" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_useEDM4hep = m_inputType.value() == "EDM4hep";
+  m_buffers.clear();
+  m_instanceId = nextInstanceId++;
+  m_crossSectionSequence = 0;
+  return StatusCode::SUCCESS;
+}
+
+GenSampleSummary::Buffer& GenSampleSummary::threadBuffer() const {
+  thread_local std::unordered_map<unsigned long, Buffer*> buffers;
+  Buffer*& buffer = buffers[m_instanceId];
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_buffers.push_back(std::make_unique<Buffer>());
+    buffer = m_buffers.back().get();
+  }
+  return *buffer;
+}
+
+StatusCode GenSampleSummary::execute(const EventContext&) const {
+  Buffer& buffer = threadBuffer();
+  SampleStatistics& statistics = buffer.statistics;
+
+  if (m_useEDM4hep) {
+    const edm4hep::MCParticleCollection* particles = m_genphandle.get();
+    for (const auto& particle : *particles) {
+      if (particle.getGeneratorStatus() != m_finalStateStatus)
+        continue;
+      const auto& momentum = particle.getMomentum();
+      const double pt = std::hypot(momentum.x, momentum.y);
+      const double eta = std::asinh(momentum.z / pt);
+      statistics.addParticle(particle.getPDG(), particle.getCharge(), pt, eta);
+    }
+  } else {
+    const HepMC3::GenEvent* evt = m_hepmchandle.get();
+    const auto& properties = ParticleProperties::instance();
+    for (const auto& particle : evt->particles()) {
+      if (particle->status() != m_finalStateStatus)
+        continue;
+      const auto& momentum = particle->momentum();
+      statistics.addParticle(particle->pid(), properties.charge(particle->pid()), momentum.perp(),
+                             std::asinh(momentum.pz() / momentum.perp()));
+    }
+    // The generators report the running estimate, so the cross section of the last event is kept
+    if (auto crossSection = evt->cross_section()) {
+      buffer.crossSection = crossSection->xsec();
+      buffer.crossSectionError = crossSection->xsec_err();
+      buffer.crossSectionSequence = ++m_crossSectionSequence;
+    }
+  }
+  statistics.endEvent();
+
+  return StatusCode::SUCCESS;
+}
+
+StatusCode GenSampleSummary::finalize() {
+  SampleStatistics statistics;
+  const Buffer* last = nullptr;
+  for (const auto& buffer : m_buffers) {
+    statistics.merge(buffer->statistics);
+    if (buffer->crossSectionSequence > 0 && (!last || buffer->crossSectionSequence > last->crossSectionSequence))
+      last = buffer.get();
+  }
+  m_buffers.clear();
+
+  // PDG codes sorted by decreasing number of particles
+  std::vector<std::pair<int, unsigned long>> pdgCounts(statistics.pdgCounts().begin(), statistics.pdgCounts().end());
+  std::sort(pdgCounts.begin(), pdgCounts.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  std::vector<int> pdgIds;
+  std::vector<double> counts;
+  for (const auto& count : pdgCounts) {
+    pdgIds.push_back(count.first);
+    counts.push_back(count.second);
+  }
+
+  const auto moments = [](const RunningMoments& m) {
+    return std::vector<double>{double(m.entries()), m.mean(), m.variance()};
+  };
+  m_numEventsMeta.put(int(statistics.events()));
+  m_multiplicityMeta.put(moments(statistics.multiplicity()));
+  m_chargedFractionMeta.put(statistics.chargedFraction());
+  m_ptMeta.put(moments(statistics.pt()));
+  m_etaMeta.put(moments(statistics.eta()));
+  m_pdgIdsMeta.put(pdgIds);
+  m_pdgCountsMeta.put(counts);
+  if (last)
+    m_crossSectionMeta.put({last->crossSection, last->crossSectionError});
+
+  info() << "Summary of " << statistics.events() << " events: " << statistics.multiplicity().mean()
+         << " final-state particles per event, charged fraction " << statistics.chargedFraction() << ", mean pt "
+         << statistics.pt().mean() << " GeV, mean eta " << statistics.eta().mean() << endmsg;
+  if (last)
+    info() << "Cross section " << last->crossSection << " +- " << last->crossSectionError << " pb" << endmsg;
+
+  return Gaudi::Algorithm::finalize();
+}
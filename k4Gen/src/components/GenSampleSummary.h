@@ -0,0 +1,80 @@
+#ifndef GENERATION_GENSAMPLESUMMARY_H
+#define GENERATION_GENSAMPLESUMMARY_H
+
+#include "Gaudi/Algorithm.h"
+#include "HepMC3/GenEvent.h"
+#include "k4FWCore/DataHandle.h"
+#include "k4FWCore/MetaDataHandle.h"
+
+#include "edm4hep/MCParticleCollection.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SampleStatistics.h"
+
+/** @class GenSampleSummary
+ *
+ *  Summary statistics of the generated sample, accumulated while the events are produced instead of re-reading the
+ *  output: mean and variance of the final-state multiplicity, pt and eta, the charged fraction, the number of
+ *  final-state particles by PDG code and, for HepMC input, the generator cross section of the last event. Every thread
+ *  fills its own statistics, which are merged and written to the run metadata at finalize.
+ */
+class GenSampleSummary : public Gaudi::Algorithm {
+
+public:
+  /// Constructor.
+  GenSampleSummary(const std::string& name, ISvcLocator* svcLoc);
+  /// Initialize.
+  virtual StatusCode initialize();
+  /// Execute.
+  virtual StatusCode execute(const EventContext&) const;
+  /// Finalize.
+  virtual StatusCode finalize();
+
+private:
+  struct Buffer {
+    SampleStatistics statistics;
+    /// cross section and its error in pb, and the order in which it was read
+    double crossSection{0.};
+    double crossSectionError{0.};
+    unsigned long crossSectionSequence{0};
+  };
+
+  /// Buffer of the calling thread, created on first use
+  Buffer& threadBuffer() const;
+
+  /// Handle for the HepMC to be read
+  mutable k4FWCore::DataHandle<HepMC3::GenEvent> m_hepmchandle{"hepmc", Gaudi::DataHandle::Reader, this};
+  /// Handle for the EDM4hep particles to be read
+  mutable k4FWCore::DataHandle<edm4hep::MCParticleCollection> m_genphandle{"GenParticles", Gaudi::DataHandle::Reader,
+                                                                           this};
+
+  Gaudi::Property<std::string> m_inputType{this, "inputType", "HepMC", "Input to summarize: HepMC or EDM4hep"};
+  Gaudi::Property<int> m_finalStateStatus{this, "finalStateStatus", 1, "Status of the particles that are counted"};
+
+  /// Run metadata written at finalize, with the name of the algorithm as prefix
+  k4FWCore::MetaDataHandle<int> m_numEventsMeta{name() + "_events", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<double>> m_multiplicityMeta{name() + "_multiplicity",
+                                                                   Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<double> m_chargedFractionMeta{name() + "_chargedFraction", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<double>> m_ptMeta{name() + "_pt", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<double>> m_etaMeta{name() + "_eta", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<int>> m_pdgIdsMeta{name() + "_pdgIds", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<double>> m_pdgCountsMeta{name() + "_pdgCounts", Gaudi::DataHandle::Writer};
+  k4FWCore::MetaDataHandle<std::vector<double>> m_crossSectionMeta{name() + "_crossSection",
+                                                                   Gaudi::DataHandle::Writer};
+
+  bool m_useEDM4hep{false};
+
+  /// Buffers of all threads, merged at finalize
+  mutable std::vector<std::unique_ptr<Buffer>> m_buffers;
+  mutable std::mutex m_buffersMutex;
+  /// Key of the buffers in the thread-local lookup, new for every initialization
+  unsigned long m_instanceId{0};
+  mutable std::atomic<unsigned long> m_crossSectionSequence{0};
+};
+
+#endif // GENERATION_GENSAMPLESUMMARY_H
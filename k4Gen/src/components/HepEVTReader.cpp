@@ -20,6 +20,7 @@ HepEVTReader::HepEVTReader(const std::string& name, ISvcLocator* svcLoc)
 
 StatusCode HepEVTReader::initialize() {
   StatusCode sc = Gaudi::Algorithm::initialize();
+  m_timeStages = m_monitorStages || !m_stageSummaryFile.empty();
 
   m_input.open(m_filename.c_str(), std::ifstream::in);
 
@@ -33,12 +34,32 @@ StatusCode HepEVTReader::initialize() {
 }
 
 StatusCode HepEVTReader::execute(const EventContext&) const {
+  StageTimer timer(m_time, m_timeStages);
+
   // First check the input file status
   if (m_input.eof()) {
     error() << "End of file reached" << endmsg;
     return StatusCode::FAILURE;
   }
 
+  edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
+  if (readEvent(m_input, NHEP, *particles).isFailure()) {
+    delete particles;
+    return StatusCode::FAILURE;
+  }
+
+  m_numParticles += particles->size();
+  m_genphandle.put(particles);
+  if (m_input.eof()) {
+    NHEP = 0;
+  } else {
+    m_input >> NHEP;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode HepEVTReader::readEvent(std::istream& input, int nParticles,
+                                   edm4hep::MCParticleCollection& particles) const {
   //  Loop over particles
   int ISTHEP;   // status code
   int IDHEP;    // PDG code
@@ -56,9 +77,7 @@ StatusCode HepEVTReader::execute(const EventContext&) const {
   double VHEP3; // z vertex position in mm
   double VHEP4; // production time in mm/c
 
-  edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
-
-  for (int IHEP = 0; IHEP < NHEP; IHEP++) {
+  for (int IHEP = 0; IHEP < nParticles; IHEP++) {
     // if (m_format == HEPEvtShort)
     //   {
     // 	m_input >> ISTHEP >> IDHEP >> JDAHEP1 >> JDAHEP2
@@ -66,16 +85,16 @@ StatusCode HepEVTReader::execute(const EventContext&) const {
     //   }
     // else
     //   {
-    m_input >> ISTHEP >> IDHEP >> JMOHEP1 >> JMOHEP2 >> JDAHEP1 >> JDAHEP2 >> PHEP1 >> PHEP2 >> PHEP3 >> PHEP4 >>
+    input >> ISTHEP >> IDHEP >> JMOHEP1 >> JMOHEP2 >> JDAHEP1 >> JDAHEP2 >> PHEP1 >> PHEP2 >> PHEP3 >> PHEP4 >>
         PHEP5 >> VHEP1 >> VHEP2 >> VHEP3 >> VHEP4;
     // }
 
-    if (m_input.eof()) {
+    if (input.eof()) {
       error() << "End of file reached before reading all the hits" << endmsg;
       return StatusCode::FAILURE;
     }
 
-    auto particle = particles->create();
+    auto particle = particles.create();
 
     particle.setPDG(IDHEP);
     particle.setGeneratorStatus(ISTHEP);
@@ -92,17 +111,15 @@ StatusCode HepEVTReader::execute(const EventContext&) const {
     });
     particle.setTime(VHEP4);
   }
-
-  m_genphandle.put(particles);
-  if (m_input.eof()) {
-    NHEP = 0;
-  } else {
-    m_input >> NHEP;
-  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode HepEVTReader::finalize() {
+  if (!m_stageSummaryFile.empty()) {
+    if (!writeStageSummary(m_stageSummaryFile, name(), m_time,
+                           {{"time read [ms]", &m_time}, {"particles", &m_numParticles}}))
+      warning() << "Could not write the stage summary to " << m_stageSummaryFile.value() << endmsg;
+  }
   m_input.close();
   return Gaudi::Algorithm::finalize();
 }
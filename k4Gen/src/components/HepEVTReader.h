@@ -14,6 +14,8 @@
 
 #include "GaudiKernel/SystemOfUnits.h"
 
+#include "StageMonitor.h"
+
 namespace edm4hep {
 class MCParticleCollection;
 }
@@ -37,6 +39,8 @@ public:
   virtual StatusCode execute(const EventContext&) const;
   /// Finalize.
   virtual StatusCode finalize();
+  /// Read the particle lines of one event from the input into the collection
+  StatusCode readEvent(std::istream& input, int nParticles, edm4hep::MCParticleCollection& particles) const;
 
 private:
   std::string m_filename;
@@ -46,6 +50,15 @@ private:
 
   /// Handle for the genparticles to be written
   mutable k4FWCore::DataHandle<edm4hep::MCParticleCollection> m_genphandle{"GenParticles", Gaudi::DataHandle::Writer, this};
+
+  /// Switch for the read timer
+  Gaudi::Property<bool> m_monitorStages{this, "monitorStages", false, "Time the reading of every event"};
+  /// JSON summary of the timer and counters written at finalize, enables the timer
+  Gaudi::Property<std::string> m_stageSummaryFile{this, "stageSummaryFile", "",
+                                                  "File for a JSON summary of the timer and counters"};
+  bool m_timeStages{false};
+  mutable Gaudi::Accumulators::StatCounter<double> m_time{this, "time read [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numParticles{this, "particles"};
 };
 
 #endif // GENERATION_HEPEVTREADER_H
@@ -1,19 +1,113 @@
 #include "HepMCDumper.h"
 
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
 #include "HepMC3/Print.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
 DECLARE_COMPONENT(HepMCDumper)
 
+namespace {
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+} // namespace
+
 HepMCDumper::HepMCDumper(const std::string& name, ISvcLocator* svcLoc) : Gaudi::Algorithm(name, svcLoc) {
   declareProperty("hepmc", m_hepmchandle, "The HepMC event to dump");
 }
 
-StatusCode HepMCDumper::initialize() { return Gaudi::Algorithm::initialize(); }
+StatusCode HepMCDumper::initialize() {
+  if (Gaudi::Algorithm::initialize().isFailure())
+    return StatusCode::FAILURE;
+
+  if (m_printEvery.value() == 0) {
+    error() << "printEvery must be at least 1" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_numEvents = 0;
+  if (!m_binaryFile.empty()) {
+    m_binary.open(m_binaryFile.value(), std::ios::binary | std::ios::trunc);
+    if (!m_binary.good()) {
+      error() << "Cannot open " << m_binaryFile.value() << " for the binary dump" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_binary.write("K4GENDMP", 8);
+    writeValue<uint32_t>(m_binary, 1);
+  }
+  return StatusCode::SUCCESS;
+}
+
+bool HepMCDumper::selected(const HepMC3::ConstGenParticlePtr& particle) const {
+  const auto& statuses = m_statuses.value();
+  const auto& pdgIds = m_pdgIds.value();
+  if (!statuses.empty() && std::find(statuses.begin(), statuses.end(), particle->status()) == statuses.end())
+    return false;
+  return pdgIds.empty() || std::find(pdgIds.begin(), pdgIds.end(), particle->pid()) != pdgIds.end();
+}
 
 StatusCode HepMCDumper::execute(const EventContext&) const {
+  const unsigned long index = m_numEvents++;
+  const unsigned long every = m_printEvery.value();
+  if (index % every != 0 || (m_printFirst.value() >= 0 && index / every >= (unsigned long)m_printFirst.value()))
+    return StatusCode::SUCCESS;
+
   const HepMC3::GenEvent* theEvent = m_hepmchandle.get();
-  HepMC3::Print::content(*theEvent);
+  if (m_printEvents.value()) {
+    // Build the printout first and write it at once, so that events of concurrent threads are not interleaved
+    std::ostringstream out;
+    if (m_statuses.value().empty() && m_pdgIds.value().empty()) {
+      HepMC3::Print::content(out, *theEvent);
+    } else {
+      out << "Event " << theEvent->event_number() << ": selected particles out of " << theEvent->particles().size()
+          << std::endl;
+      for (const auto& particle : theEvent->particles()) {
+        if (selected(particle))
+          HepMC3::Print::line(out, particle, true);
+      }
+    }
+    std::cout << out.str() << std::flush;
+  }
+  if (m_binary.is_open())
+    writeBinary(*theEvent);
+
   return StatusCode::SUCCESS;
 }
 
-StatusCode HepMCDumper::finalize() { return Gaudi::Algorithm::finalize(); }
+void HepMCDumper::writeBinary(const HepMC3::GenEvent& event) const {
+  std::vector<HepMC3::ConstGenParticlePtr> particles;
+  for (const auto& particle : event.particles()) {
+    if (selected(particle))
+      particles.push_back(particle);
+  }
+
+  std::lock_guard<std::mutex> lock(m_binaryMutex);
+  writeValue<uint64_t>(m_binary, event.event_number());
+  writeValue<uint32_t>(m_binary, particles.size());
+  for (const auto& particle : particles) {
+    const auto& momentum = particle->momentum();
+    const auto& vertex = particle->production_vertex();
+    const HepMC3::FourVector position = vertex ? vertex->position() : HepMC3::FourVector::ZERO_VECTOR();
+    writeValue<int32_t>(m_binary, particle->pid());
+    writeValue<int32_t>(m_binary, particle->status());
+    for (double value : {momentum.px(), momentum.py(), momentum.pz(), momentum.e(), position.x(), position.y(),
+                         position.z(), position.t()})
+      writeValue<float>(m_binary, value);
+  }
+}
+
+StatusCode HepMCDumper::finalize() {
+  if (m_binary.is_open()) {
+    m_binary.close();
+    if (m_binary.fail()) {
+      error() << "Error writing the binary dump to " << m_binaryFile.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return Gaudi::Algorithm::finalize();
+}
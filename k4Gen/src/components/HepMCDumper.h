@@ -7,6 +7,21 @@
 
 #include "HepMC3/GenEvent.h"
 
+#include <atomic>
+#include <fstream>
+#include <mutex>
+
+/** @class HepMCDumper
+ *
+ *  Prints the HepMC events, or a selection of them, to stdout. At realistic multiplicities printing every event
+ *  produces a huge log, so the dump can be limited to every Nth event and to the first K of those, and to particles
+ *  of selected statuses and PDG codes. The selected particles can also be written to a compact binary file instead
+ *  of, or in addition to, the printout.
+ *
+ *  The binary file starts with the 8 characters "K4GENDMP" and a uint32 format version (1). Every event is then a
+ *  uint64 event number, a uint32 number of particles and, for every particle, int32 PDG code, int32 status, float
+ *  px, py, pz, E (GeV) and x, y, z, t (mm) of the production vertex. Numbers are in the byte order of the machine.
+ */
 class HepMCDumper : public Gaudi::Algorithm {
 
 public:
@@ -20,8 +35,24 @@ public:
   virtual StatusCode finalize();
 
 private:
+  /// Whether a particle passes the status and PDG code selection
+  bool selected(const HepMC3::ConstGenParticlePtr& particle) const;
+  void writeBinary(const HepMC3::GenEvent& event) const;
+
   /// Handle for the HepMC to be read
   mutable k4FWCore::DataHandle<HepMC3::GenEvent> m_hepmchandle{"hepmc", Gaudi::DataHandle::Reader, this};
+
+  Gaudi::Property<unsigned int> m_printEvery{this, "printEvery", 1, "Dump only every Nth event"};
+  Gaudi::Property<int> m_printFirst{this, "printFirst", -1,
+                                    "Dump at most this many events (counting only every Nth event), -1 for all"};
+  Gaudi::Property<std::vector<int>> m_statuses{this, "statuses", {}, "Dump only particles with these statuses"};
+  Gaudi::Property<std::vector<int>> m_pdgIds{this, "pdgIds", {}, "Dump only particles with these PDG codes"};
+  Gaudi::Property<bool> m_printEvents{this, "printEvents", true, "Print the dumped events to stdout"};
+  Gaudi::Property<std::string> m_binaryFile{this, "binaryFile", "", "File for a binary dump of the dumped events"};
+
+  mutable std::atomic<unsigned long> m_numEvents{0};
+  mutable std::ofstream m_binary;
+  mutable std::mutex m_binaryMutex;
 };
 
 #endif // GENERATION_HEPMCDUMPER_H
@@ -8,6 +8,8 @@
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
 
+#include "Generation/PileUpInteractionRanges.h"
+
 DECLARE_COMPONENT(HepMCFullMerge)
 
 HepMCFullMerge::HepMCFullMerge(const std::string& type, const std::string& name, const IInterface* parent)
@@ -25,27 +27,63 @@ StatusCode HepMCFullMerge::initialize() {
 }
 
 StatusCode HepMCFullMerge::merge(HepMC3::GenEvent& signalEvent, const std::vector<HepMC3::GenEvent>& eventVector) {
-  for (auto it = eventVector.cbegin(), end = eventVector.cend(); it != end; ++it) {
-    // keep track of which vertex in full event corresponds to which vertex in merged event
-    std::unordered_map<std::shared_ptr<const HepMC3::GenVertex>, std::shared_ptr<HepMC3::GenVertex>>
-        inputToMergedVertexMap;
-    for (auto& v : it->vertices()) {
-      auto outvertex = std::make_shared<HepMC3::GenVertex>(v->position());
-      inputToMergedVertexMap[v] = outvertex;
-      signalEvent.add_vertex(outvertex);
+  PileUpInteractionRanges::Collector interactions;
+  for (const auto& pileUpEvent : eventVector) {
+    const int firstParticle = signalEvent.particles().size();
+    const int firstVertex = signalEvent.vertices().size();
+    StatusCode sc = merge(signalEvent, pileUpEvent);
+    if (!sc.isSuccess())
+      return sc;
+    interactions.add(signalEvent, firstParticle, firstVertex);
+  }
+  interactions.store(signalEvent);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode HepMCFullMerge::merge(HepMC3::GenEvent& signalEvent, const HepMC3::GenEvent& pileUpEvent) {
+  // keep track of which vertex in full event corresponds to which vertex in merged event
+  std::unordered_map<std::shared_ptr<const HepMC3::GenVertex>, std::shared_ptr<HepMC3::GenVertex>>
+      inputToMergedVertexMap;
+  for (auto& v : pileUpEvent.vertices()) {
+    auto outvertex = std::make_shared<HepMC3::GenVertex>(v->position());
+    inputToMergedVertexMap[v] = outvertex;
+    signalEvent.add_vertex(outvertex);
+  }
+  for (auto& p : pileUpEvent.particles()) {
+    // ownership of the particle is given to the vertex
+    auto newparticle = std::make_shared<HepMC3::GenParticle>(*p);
+    // attach particles to correct vertices in merged event
+    if (p->end_vertex()) {
+      inputToMergedVertexMap[p->end_vertex()]->add_particle_in(newparticle);
+    }
+    if (p->production_vertex()) {
+      inputToMergedVertexMap[p->production_vertex()]->add_particle_out(newparticle);
     }
-    for (auto& p : it->particles()) {
-      // ownership of the particle is given to the vertex
-      auto newparticle = std::make_shared<HepMC3::GenParticle>(*p);
-      // attach particles to correct vertices in merged event
-      if (p->end_vertex()) {
-        inputToMergedVertexMap[p->end_vertex()]->add_particle_in(newparticle);
-      }
-      if (p->production_vertex()) {
-        inputToMergedVertexMap[p->production_vertex()]->add_particle_out(newparticle);
-      }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode HepMCFullMerge::merge(HepMC3::GenEvent& signalEvent, HepMC3::GenEvent&& pileUpEvent) {
+  // vertex ids in an event are -1, -2, ..., so they index the merged vertices directly
+  std::vector<std::shared_ptr<HepMC3::GenVertex>> mergedVertices;
+  mergedVertices.reserve(pileUpEvent.vertices().size());
+  for (auto& v : pileUpEvent.vertices()) {
+    mergedVertices.push_back(std::make_shared<HepMC3::GenVertex>(v->position()));
+  }
+  for (auto& p : pileUpEvent.particles()) {
+    auto newparticle = std::make_shared<HepMC3::GenParticle>(p->data());
+    if (p->end_vertex()) {
+      mergedVertices[-p->end_vertex()->id() - 1]->add_particle_in(newparticle);
+    }
+    if (p->production_vertex()) {
+      mergedVertices[-p->production_vertex()->id() - 1]->add_particle_out(newparticle);
     }
   }
+  // the vertices are added once they are connected, which adds their particles in one go
+  for (auto& v : mergedVertices) {
+    signalEvent.add_vertex(v);
+  }
+  pileUpEvent.clear();
   return StatusCode::SUCCESS;
 }
 
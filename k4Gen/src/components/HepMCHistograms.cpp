@@ -4,9 +4,40 @@
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unordered_map>
+
 DECLARE_COMPONENT(HepMCHistograms)
 
-HepMCHistograms::HepMCHistograms(const std::string& name, ISvcLocator* svcLoc) : Gaudi::Algorithm(name, svcLoc) {
+namespace {
+std::atomic<unsigned long> nextInstanceId{0};
+
+struct ObservableDefinition {
+  const char* name;
+  const char* histName;
+  const char* title;
+  int nBins;
+  double min;
+  double max;
+};
+
+// Names, titles and default binnings, in the order of HepMCHistograms::Observable
+const ObservableDefinition observableDefinitions[] = {
+    {"pt", "GenPt", "Generated particles pT", 100, .1, 10},
+    {"eta", "GenEta", "Generated particles Pseudorapidity", 100, -10, 10},
+    {"phi", "GenPhi", "Generated particles azimuthal angle", 100, -M_PI, M_PI},
+    {"energy", "GenE", "Generated particles energy", 100, 0, 100},
+    {"d0", "GenD0", "Transversal Impact Parameter", 100, 0, 10},
+    {"z0", "GenZ0", "Longitudinal Impact Parameter", 100, -30, 30},
+    {"nParticles", "GenNParticles", "Generated particles per event", 100, 0, 1000},
+    {"nVertices", "GenNVertices", "Generated vertices per event", 100, 0, 1000},
+};
+} // namespace
+
+HepMCHistograms::HepMCHistograms(const std::string& name, ISvcLocator* svcLoc)
+    : Gaudi::Algorithm(name, svcLoc) {
   declareProperty("hepmc", m_hepmchandle);
 }
 
@@ -20,48 +51,125 @@ StatusCode HepMCHistograms::initialize() {
     return StatusCode::FAILURE;
   }
 
-  m_pt = new TH1F("GenPt", "Generated particles pT", 100, .1, 10);
-  if (m_ths->regHist("/rec/GenPt", m_pt).isFailure()) {
-    error() << "Couldn't register GenPt" << endmsg;
-  }
-
-  m_eta = new TH1F("GenEta", "Generated particles Pseudorapidity", 100, -10, 10);
-  if (m_ths->regHist("/rec/GenEta", m_eta).isFailure()) {
-    error() << "Couldn't register GenEta" << endmsg;
+  m_particleHistograms.clear();
+  m_vertexHistograms.clear();
+  m_eventHistograms.clear();
+  m_bufferSize = 0;
+  for (const auto& name : m_observables) {
+    const auto* definition = std::find_if(std::begin(observableDefinitions), std::end(observableDefinitions),
+                                          [&name](const ObservableDefinition& d) { return name == d.name; });
+    if (definition == std::end(observableDefinitions)) {
+      error() << "Unknown observable " << name << endmsg;
+      return StatusCode::FAILURE;
+    }
+    Binning binning{definition->nBins, definition->min, definition->max, 0.};
+    auto custom = m_binnings.value().find(name);
+    if (custom != m_binnings.value().end()) {
+      if (custom->second.size() != 3 || custom->second[0] < 1 || !(custom->second[2] > custom->second[1])) {
+        error() << "Binning of " << name << " must be [number of bins, min, max] with min < max" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      binning = {int(custom->second[0]), custom->second[1], custom->second[2], 0.};
+    }
+    binning.scale = binning.nBins / (binning.max - binning.min);
+
+    TH1F* hist = new TH1F(definition->histName, definition->title, binning.nBins, binning.min, binning.max);
+    if (m_ths->regHist(m_histogramPath.value() + definition->histName, hist).isFailure()) {
+      error() << "Couldn't register " << definition->histName << endmsg;
+    }
+
+    const auto observable = static_cast<Observable>(definition - std::begin(observableDefinitions));
+    Histogram histogram{observable, binning, m_bufferSize, hist};
+    m_bufferSize += binning.nBins + 2;
+    if (observable == Observable::D0 || observable == Observable::Z0)
+      m_vertexHistograms.push_back(histogram);
+    else if (observable == Observable::NParticles || observable == Observable::NVertices)
+      m_eventHistograms.push_back(histogram);
+    else
+      m_particleHistograms.push_back(histogram);
   }
+  m_buffers.clear();
+  m_instanceId = nextInstanceId++;
 
-  m_d0 = new TH1F("GenD0", "Transversal Impact Parameter", 100, 0, 10);
-  if (m_ths->regHist("/rec/GenD0", m_d0).isFailure()) {
-    error() << "Couldn't register GenD0" << endmsg;
-  }
+  return StatusCode::SUCCESS;
+}
 
-  m_z0 = new TH1F("GenZ0", "Longitudinal Impact Parameter", 100, -30, 30);
-  if (m_ths->regHist("/rec/GenZ0", m_z0).isFailure()) {
-    error() << "Couldn't register GenZ0" << endmsg;
+HepMCHistograms::Buffer& HepMCHistograms::threadBuffer() const {
+  thread_local std::unordered_map<unsigned long, Buffer*> buffers;
+  Buffer*& buffer = buffers[m_instanceId];
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_buffers.push_back(std::make_unique<Buffer>(m_bufferSize, 0.));
+    buffer = m_buffers.back().get();
   }
-
-  return StatusCode::SUCCESS;
+  return *buffer;
 }
 
 StatusCode HepMCHistograms::execute(const EventContext&) const {
   auto evt = m_hepmchandle.get();
+  Buffer& buffer = threadBuffer();
+
+  if (!m_particleHistograms.empty()) {
+    for (auto p : evt->particles()) {
+      const auto& momentum = p->momentum();
+      for (const auto& h : m_particleHistograms) {
+        double value = 0.;
+        switch (h.observable) {
+        case Observable::Pt:
+          value = momentum.perp();
+          break;
+        case Observable::Eta:
+          value = momentum.eta();
+          break;
+        case Observable::Phi:
+          value = momentum.phi();
+          break;
+        default:
+          value = momentum.e();
+        }
+        buffer[h.offset + h.binning.bin(value)] += 1.;
+      }
+    }
+  }
 
-  info() << "Processing event with " << evt->particles().size() << " particles" << endmsg;
-
-  for (auto p : evt->particles()) {
-    m_eta->Fill(p->momentum().eta());
-    m_pt->Fill(p->momentum().perp());
+  if (!m_vertexHistograms.empty()) {
+    for (auto v : evt->vertices()) {
+      const auto& position = v->position();
+      for (const auto& h : m_vertexHistograms) {
+        const double value = h.observable == Observable::D0 ? position.perp() : position.z();
+        buffer[h.offset + h.binning.bin(value)] += 1.;
+      }
+    }
   }
 
-  for (auto v : evt->vertices()) {
-    m_d0->Fill(v->position().perp());
-    m_z0->Fill(v->position().z());
+  for (const auto& h : m_eventHistograms) {
+    const double value = h.observable == Observable::NParticles ? evt->particles().size() : evt->vertices().size();
+    buffer[h.offset + h.binning.bin(value)] += 1.;
   }
 
   return StatusCode::SUCCESS;
 }
 
 StatusCode HepMCHistograms::finalize() {
+  // Add up the buffers of all threads and copy them into the histograms, including under- and overflow
+  Buffer merged(m_bufferSize, 0.);
+  for (const auto& buffer : m_buffers) {
+    for (std::size_t i = 0; i < m_bufferSize; ++i)
+      merged[i] += (*buffer)[i];
+  }
+  for (const auto* histograms : {&m_particleHistograms, &m_vertexHistograms, &m_eventHistograms}) {
+    for (const auto& h : *histograms) {
+      double entries = 0.;
+      for (int bin = 0; bin <= h.binning.nBins + 1; ++bin) {
+        h.hist->SetBinContent(bin, merged[h.offset + bin]);
+        entries += merged[h.offset + bin];
+      }
+      h.hist->ResetStats();
+      h.hist->SetEntries(entries);
+    }
+  }
+  m_buffers.clear();
+
   if (Gaudi::Algorithm::finalize().isFailure())
     return StatusCode::FAILURE;
 
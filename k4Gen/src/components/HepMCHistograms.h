@@ -8,6 +8,18 @@
 
 #include "TH1F.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** @class HepMCHistograms
+ *
+ *  Validation histograms of the generated particles and vertices. The events are histogrammed into plain arrays with
+ *  fixed binning, one set per thread, which are added up and copied into the THistSvc histograms at finalize. This
+ *  avoids the cost of TH1::Fill for every particle and makes the algorithm safe to run concurrently, so that the
+ *  histograms can be kept on in production.
+ */
 class HepMCHistograms : public Gaudi::Algorithm {
 
 public:
@@ -21,16 +33,63 @@ public:
   virtual StatusCode finalize();
 
 private:
+  /// Quantities that can be histogrammed
+  enum class Observable { Pt, Eta, Phi, Energy, D0, Z0, NParticles, NVertices };
+
+  /// Fixed binning with the bin numbering of ROOT: 0 is the underflow, nBins + 1 the overflow
+  struct Binning {
+    int nBins;
+    double min;
+    double max;
+    double scale; ///< bins per unit
+    int bin(double x) const {
+      if (!(x >= min)) // also catches NaN
+        return 0;
+      if (x >= max)
+        return nBins + 1;
+      const int i = 1 + int((x - min) * scale);
+      return i > nBins ? nBins : i;
+    }
+  };
+
+  struct Histogram {
+    Observable observable;
+    Binning binning;
+    std::size_t offset; ///< first bin of the histogram in the buffers
+    TH1F* hist;
+  };
+
+  /// Bin contents of all histograms, filled by one thread
+  using Buffer = std::vector<double>;
+
+  /// Buffer of the calling thread, created on first use
+  Buffer& threadBuffer() const;
+
   /// Handle for the HepMC to be read
   mutable k4FWCore::DataHandle<HepMC3::GenEvent> m_hepmchandle{"HepMC", Gaudi::DataHandle::Reader, this};
 
+  Gaudi::Property<std::vector<std::string>> m_observables{
+      this,
+      "observables",
+      {"pt", "eta", "d0", "z0"},
+      "Quantities to histogram: pt, eta, phi, energy (particles), d0, z0 (vertices), nParticles, nVertices (events)"};
+  Gaudi::Property<std::map<std::string, std::vector<double>>> m_binnings{
+      this, "binnings", {}, "Binnings as [number of bins, min, max] by observable, replacing the defaults"};
+  Gaudi::Property<std::string> m_histogramPath{this, "histogramPath", "/rec/",
+                                               "THistSvc directory the histograms are registered in"};
+
   SmartIF<ITHistSvc> m_ths; ///< THistogram service
 
-  TH1F* m_pt{nullptr};  ///< histogram for pT of particles
-  TH1F* m_eta{nullptr}; ///< histogram for pseudorapidity of particles
+  std::vector<Histogram> m_particleHistograms;
+  std::vector<Histogram> m_vertexHistograms;
+  std::vector<Histogram> m_eventHistograms;
+  std::size_t m_bufferSize{0};
 
-  TH1F* m_d0{nullptr}; ///< histogram for transversal IP
-  TH1F* m_z0{nullptr}; ///< histogram for longidudinal IP
+  /// Buffers of all threads, merged at finalize
+  mutable std::vector<std::unique_ptr<Buffer>> m_buffers;
+  mutable std::mutex m_buffersMutex;
+  /// Key of the buffers in the thread-local lookup, new for every initialization
+  unsigned long m_instanceId{0};
 };
 
 #endif // GENERATION_HEPMCHISTOGRAMS_H
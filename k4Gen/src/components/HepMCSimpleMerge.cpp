@@ -8,6 +8,8 @@
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
 
+#include "Generation/PileUpInteractionRanges.h"
+
 DECLARE_COMPONENT(HepMCSimpleMerge)
 
 HepMCSimpleMerge::HepMCSimpleMerge(const std::string& type, const std::string& name, const IInterface* parent)
@@ -25,29 +27,68 @@ StatusCode HepMCSimpleMerge::initialize() {
 }
 
 StatusCode HepMCSimpleMerge::merge(HepMC3::GenEvent& signalEvent, const std::vector<HepMC3::GenEvent>& eventVector) {
+  PileUpInteractionRanges::Collector interactions;
+  for (const auto& pileUpEvent : eventVector) {
+    const int firstParticle = signalEvent.particles().size();
+    const int firstVertex = signalEvent.vertices().size();
+    StatusCode sc = merge(signalEvent, pileUpEvent);
+    if (!sc.isSuccess())
+      return sc;
+    interactions.add(signalEvent, firstParticle, firstVertex);
+  }
+  interactions.store(signalEvent);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode HepMCSimpleMerge::merge(HepMC3::GenEvent& signalEvent, const HepMC3::GenEvent& pileUpEvent) {
   // iterate over vertices and add them to signalEvent
-  for (auto it = eventVector.cbegin(), end = eventVector.cend(); it != end; ++it) {
-    std::unordered_map<std::shared_ptr<const HepMC3::GenVertex>, std::shared_ptr<HepMC3::GenVertex>>
-        inputToMergedVertexMap;
-    for (auto& v : it->vertices()) {
-      auto newVertex = std::make_shared<HepMC3::GenVertex>(v->position());
-      inputToMergedVertexMap[v] = newVertex;
+  std::unordered_map<std::shared_ptr<const HepMC3::GenVertex>, std::shared_ptr<HepMC3::GenVertex>>
+      inputToMergedVertexMap;
+  for (auto& v : pileUpEvent.vertices()) {
+    auto newVertex = std::make_shared<HepMC3::GenVertex>(v->position());
+    inputToMergedVertexMap[v] = newVertex;
+  }
+  for (auto& p : pileUpEvent.particles()) {
+    // simple check if final-state particle:
+    // has no end vertex and correct status code meaning no further decays
+    if (!p->end_vertex() && p->status() == 1) {
+      // ownership of the particle  (newParticle) is then given to the vertex (newVertex)
+      auto newParticle = std::make_shared<HepMC3::GenParticle>(*p);
+      // each pile up particle is associated to a new production vertex
+      // the position information is preserved
+      // ownership of the vertex (newVertex) is given to the event (newEvent)
+      auto newVertex = inputToMergedVertexMap[p->production_vertex()];
+      newVertex->add_particle_out(newParticle);
+      signalEvent.add_vertex(newVertex);
     }
-    for (auto& p : it->particles()) {
-      // simple check if final-state particle:
-      // has no end vertex and correct status code meaning no further decays
-      if (!p->end_vertex() && p->status() == 1) {
-        // ownership of the particle  (newParticle) is then given to the vertex (newVertex)
-        auto newParticle = std::make_shared<HepMC3::GenParticle>(*p);
-        // each pile up particle is associated to a new production vertex
-        // the position information is preserved
-        // ownership of the vertex (newVertex) is given to the event (newEvent)
-        auto newVertex = inputToMergedVertexMap[p->production_vertex()];
-        newVertex->add_particle_out(newParticle);
-        signalEvent.add_vertex(newVertex);
-      }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode HepMCSimpleMerge::merge(HepMC3::GenEvent& signalEvent, HepMC3::GenEvent&& pileUpEvent) {
+  // vertex ids in an event are -1, -2, ..., so they index the merged vertices directly;
+  // only the vertices with final-state particles are created
+  std::vector<std::shared_ptr<HepMC3::GenVertex>> mergedVertices(pileUpEvent.vertices().size());
+  for (auto& p : pileUpEvent.particles()) {
+    if (p->end_vertex() || p->status() != 1)
+      continue;
+    auto prodVertex = p->production_vertex();
+    std::shared_ptr<HepMC3::GenVertex> newVertex;
+    if (prodVertex) {
+      auto& mergedVertex = mergedVertices[-prodVertex->id() - 1];
+      if (!mergedVertex)
+        mergedVertex = std::make_shared<HepMC3::GenVertex>(prodVertex->position());
+      newVertex = mergedVertex;
+    } else {
+      newVertex = std::make_shared<HepMC3::GenVertex>();
     }
+    newVertex->add_particle_out(std::make_shared<HepMC3::GenParticle>(p->data()));
+  }
+  for (auto& v : mergedVertices) {
+    if (v)
+      signalEvent.add_vertex(v);
   }
+  pileUpEvent.clear();
   return StatusCode::SUCCESS;
 }
 
@@ -24,6 +24,20 @@ public:
    *  @param[in] eventVector is the vector of pile-up GenEvents
    */
   virtual StatusCode merge(HepMC3::GenEvent& signalEvent, const std::vector<HepMC3::GenEvent>& eventVector) final;
+
+  /** Merge a single pile-up event into the signalEvent
+   *  @param[in/out] signalEvent is the signal event that will be enriched with the pile-up event
+   *  @param[in] pileUpEvent is the pile-up GenEvent
+   */
+  virtual StatusCode merge(HepMC3::GenEvent& signalEvent, const HepMC3::GenEvent& pileUpEvent) final;
+
+  /** Merge a single pile-up event that is not needed afterwards into the signalEvent
+   *  The vertices are looked up by their index instead of through a map, the particles are created from their plain
+   *  data, and the pile-up event is cleared right after the merge to free its memory.
+   *  @param[in/out] signalEvent is the signal event that will be enriched with the pile-up event
+   *  @param[in] pileUpEvent is the pile-up GenEvent, empty afterwards
+   */
+  virtual StatusCode merge(HepMC3::GenEvent& signalEvent, HepMC3::GenEvent&& pileUpEvent) final;
 };
 
 #endif // GENERATION_HEPMCPILEMERGETOOL_H
@@ -1,11 +1,12 @@
 #include "HepMCToEDMConverter.h"
+#include "ParticleProperties.h"
 // HepMC
 #include "HepMC3/GenVertex.h"
-// HepPDT
-#include "HepPDT/ParticleID.hh"
 // EDM4hep
 #include "edm4hep/MCParticleCollection.h"
 
+#include "Generation/PileUpInteractionRanges.h"
+
 DECLARE_COMPONENT(HepMCToEDMConverter)
 
 edm4hep::MutableMCParticle
@@ -14,8 +15,7 @@ HepMCToEDMConverter::convert(std::shared_ptr<const HepMC3::GenParticle> hepmcPar
   edm_particle.setPDG(hepmcParticle->pdg_id());
   edm_particle.setGeneratorStatus(hepmcParticle->status());
   // look up charge from pdg_id
-  HepPDT::ParticleID particleID(hepmcParticle->pdg_id());
-  edm_particle.setCharge(static_cast<float>(particleID.charge()));
+  edm_particle.setCharge(static_cast<float>(ParticleProperties::instance().charge(hepmcParticle->pdg_id())));
   // convert momentum
   auto p = hepmcParticle->momentum();
   edm_particle.setMomentum({p.px(), p.py(), p.pz()});
@@ -49,49 +49,87 @@ HepMCToEDMConverter::HepMCToEDMConverter(const std::string& name, ISvcLocator* s
     : Gaudi::Algorithm(name, svcLoc) {
   declareProperty("hepmc", m_hepmchandle, "HepMC event handle (input)");
   declareProperty("GenParticles", m_genphandle, "Generated particles collection (output)");
+  declareProperty("PileUpInteractionRanges", m_interactionRangesHandle,
+                  "Begin/end index pairs of the pileup interactions in the generated particles collection (output)");
 }
 
-StatusCode HepMCToEDMConverter::initialize() { return Gaudi::Algorithm::initialize(); }
+StatusCode HepMCToEDMConverter::initialize() {
+  m_timeStages = m_monitorStages || !m_stageSummaryFile.empty();
+  if (m_monitorMemory) {
+    m_allocationHook = AllocationHook::find();
+    if (nullptr == m_allocationHook)
+      warning() << "Allocation hook not preloaded, only the peak RSS is monitored. Run with "
+                << "LD_PRELOAD=libk4GenAllocationHook.so to count the allocations of the conversion." << endmsg;
+  }
+  return Gaudi::Algorithm::initialize();
+}
 
 StatusCode HepMCToEDMConverter::execute(const EventContext&) const {
+  StageTimer timer(m_time, m_timeStages);
   const HepMC3::GenEvent* evt = m_hepmchandle.get();
   edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
+  StageMemoryTotals conversionMemory;
+  {
+    StageMemory memory(conversionMemory, m_allocationHook);
+    convertEvent(*evt, *particles);
+  }
+  m_numParticles += particles->size();
+  if (m_allocationHook)
+    m_memoryConversion.fill(conversionMemory);
+  if (m_monitorMemory)
+    m_peakRss += peakRssMB();
+  m_genphandle.put(particles);
+  // only events with merged pileup have interaction ranges
+  if (PileUpInteractionRanges::present(*evt)) {
+    auto* interactionRanges = m_interactionRangesHandle.createAndPut();
+    for (const auto& range : PileUpInteractionRanges::particleRanges(*evt)) {
+      interactionRanges->push_back(range.first);
+      interactionRanges->push_back(range.second);
+    }
+  }
+  return StatusCode::SUCCESS;
+}
 
-  std::unordered_map<unsigned int, edm4hep::MutableMCParticle> _map;
-  for (auto _p : evt->particles()) {
+void HepMCToEDMConverter::convertEvent(const HepMC3::GenEvent& evt, edm4hep::MCParticleCollection& particles) const {
+  // HepMC particle ids are 1, 2, ... in the order of the event, so converting in that order keeps the index of every
+  // particle, which the pileup interaction ranges refer to
+  std::vector<edm4hep::MutableMCParticle> converted;
+  converted.reserve(evt.particles().size());
+  for (auto _p : evt.particles()) {
     verbose() << "Converting HepMC particle with PDG ID \"" << _p->pdg_id() << "\" and ID \"" << _p->id() << "\""
               << endmsg;
-    if (_map.find(_p->id()) == _map.end()) {
-      edm4hep::MutableMCParticle edm_particle = convert(_p);
-      _map.insert({_p->id(), edm_particle});
-    }
-    // mother/daughter links
+    converted.push_back(convert(_p));
+  }
+  // mother/daughter links
+  for (auto _p : evt.particles()) {
+    auto& edm_particle = converted[_p->id() - 1];
     auto prodvertex = _p->production_vertex();
     if (nullptr != prodvertex) {
       for (auto particle_mother : prodvertex->particles_in()) {
-        if (_map.find(particle_mother->id()) == _map.end()) {
-          edm4hep::MutableMCParticle edm_particle = convert(particle_mother);
-          _map.insert({particle_mother->id(), edm_particle});
-        }
-        _map[_p->id()].addToParents(_map[particle_mother->id()]);
+        edm_particle.addToParents(converted[particle_mother->id() - 1]);
       }
     }
     auto endvertex = _p->end_vertex();
     if (nullptr != endvertex) {
       for (auto particle_daughter : endvertex->particles_out()) {
-        if (_map.find(particle_daughter->id()) == _map.end()) {
-          auto edm_particle = convert(particle_daughter);
-          _map.insert({particle_daughter->id(), edm_particle});
-        }
-        _map[_p->id()].addToDaughters(_map[particle_daughter->id()]);
+        edm_particle.addToDaughters(converted[particle_daughter->id() - 1]);
       }
     }
   }
-  for (auto particle_pair : _map) {
-    particles->push_back(particle_pair.second);
+  for (auto& particle : converted) {
+    particles.push_back(particle);
   }
-  m_genphandle.put(particles);
-  return StatusCode::SUCCESS;
 }
 
-StatusCode HepMCToEDMConverter::finalize() { return Gaudi::Algorithm::finalize(); }
+StatusCode HepMCToEDMConverter::finalize() {
+  if (!m_stageSummaryFile.empty()) {
+    StageCounters counters{{"time conversion [ms]", &m_time}, {"particles", &m_numParticles}};
+    if (m_monitorMemory) {
+      m_memoryConversion.addTo(counters);
+      counters.emplace_back("peak RSS [MB]", &m_peakRss);
+    }
+    if (!writeStageSummary(m_stageSummaryFile, name(), m_time, counters))
+      warning() << "Could not write the stage summary to " << m_stageSummaryFile.value() << endmsg;
+  }
+  return Gaudi::Algorithm::finalize();
+}
@@ -9,6 +9,13 @@
 #include "HepMC3/GenEvent.h"
 #include "HepMC3/GenParticle.h"
 
+#include "podio/UserDataCollection.h"
+
+#include <cstdint>
+
+#include "MemoryMonitor.h"
+#include "StageMonitor.h"
+
 namespace edm4hep {
 class MCParticleCollection;
 class MutableMCParticle;
@@ -25,6 +32,8 @@ public:
   virtual StatusCode execute(const EventContext&) const;
   /// Finalize.
   virtual StatusCode finalize();
+  /// Convert all particles of a HepMC event, with their mother/daughter links, into the collection
+  void convertEvent(const HepMC3::GenEvent& evt, edm4hep::MCParticleCollection& particles) const;
 
 private:
   /// list of hepmc statuses that will be converted.
@@ -35,6 +44,26 @@ private:
   mutable k4FWCore::DataHandle<HepMC3::GenEvent> m_hepmchandle{"hepmc", Gaudi::DataHandle::Reader, this};
   /// Handle for the genparticles to be written
   mutable k4FWCore::DataHandle<edm4hep::MCParticleCollection> m_genphandle{"GenParticles", Gaudi::DataHandle::Writer, this};
+  /// Handle for the [begin, end) index pairs of the merged pileup interactions in the genparticles collection
+  mutable k4FWCore::DataHandle<podio::UserDataCollection<int32_t>> m_interactionRangesHandle{
+      "PileUpInteractionRanges", Gaudi::DataHandle::Writer, this};
+
+  /// Switch for the conversion timer
+  Gaudi::Property<bool> m_monitorStages{this, "monitorStages", false, "Time the conversion of every event"};
+  /// JSON summary of the timer and counters written at finalize, enables the timer
+  Gaudi::Property<std::string> m_stageSummaryFile{this, "stageSummaryFile", "",
+                                                  "File for a JSON summary of the timer and counters"};
+  bool m_timeStages{false};
+  mutable Gaudi::Accumulators::StatCounter<double> m_time{this, "time conversion [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numParticles{this, "particles"};
+
+  /// Switch for the allocation counters of the conversion, which need the preloaded allocation hook, and the peak RSS
+  Gaudi::Property<bool> m_monitorMemory{this, "monitorMemory", false,
+                                        "Count allocations and heap peak of the conversion (needs LD_PRELOAD of "
+                                        "libk4GenAllocationHook.so) and record the peak RSS of every event"};
+  const AllocationHook* m_allocationHook{nullptr};
+  mutable StageMemoryCounters m_memoryConversion{this, "conversion"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_peakRss{this, "peak RSS [MB]"};
 
   edm4hep::MutableMCParticle convert(std::shared_ptr<const HepMC3::GenParticle> hepmcParticle) const;
 };
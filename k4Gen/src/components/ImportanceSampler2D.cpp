@@ -0,0 +1,59 @@
+
+#include "ImportanceSampler2D.h"
+
+namespace {
+bool increasing(const std::vector<double>& edges) {
+  if (edges.size() < 2)
+    return false;
+  for (std::size_t i = 1; i < edges.size(); ++i)
+    if (!(edges[i] > edges[i - 1]))
+      return false;
+  return true;
+}
+} // namespace
+
+bool ImportanceSampler2D::build(const std::vector<double>& xEdges, const std::vector<double>& yEdges,
+                                const std::vector<double>& density) {
+  m_xEdges.clear();
+  m_yEdges.clear();
+  m_weights.clear();
+  m_bins = AliasTable();
+  if (!increasing(xEdges) || !increasing(yEdges))
+    return false;
+  const std::size_t nX = xEdges.size() - 1;
+  const std::size_t nY = yEdges.size() - 1;
+  if (density.size() != nX * nY)
+    return false;
+
+  // probability of a bin is its density times its area
+  const double totalArea = (xEdges.back() - xEdges.front()) * (yEdges.back() - yEdges.front());
+  std::vector<double> binWeights(nX * nY);
+  std::vector<double> areaFractions(nX * nY);
+  for (std::size_t ix = 0; ix < nX; ++ix) {
+    for (std::size_t iy = 0; iy < nY; ++iy) {
+      const std::size_t bin = ix * nY + iy;
+      areaFractions[bin] = (xEdges[ix + 1] - xEdges[ix]) * (yEdges[iy + 1] - yEdges[iy]) / totalArea;
+      binWeights[bin] = density[bin] * areaFractions[bin];
+    }
+  }
+  if (!m_bins.build(binWeights))
+    return false;
+
+  // flat probability of the bin over the probability to draw it
+  m_weights.resize(nX * nY);
+  for (std::size_t bin = 0; bin < nX * nY; ++bin)
+    m_weights[bin] = m_bins.probability(bin) > 0. ? areaFractions[bin] / m_bins.probability(bin) : 0.;
+  m_xEdges = xEdges;
+  m_yEdges = yEdges;
+  return true;
+}
+
+double ImportanceSampler2D::sample(double u1, double u2, double u3, double u4, double& x, double& y) const {
+  const std::size_t bin = m_bins.sample(u1, u2);
+  const std::size_t nY = m_yEdges.size() - 1;
+  const std::size_t ix = bin / nY;
+  const std::size_t iy = bin % nY;
+  x = m_xEdges[ix] + u3 * (m_xEdges[ix + 1] - m_xEdges[ix]);
+  y = m_yEdges[iy] + u4 * (m_yEdges[iy + 1] - m_yEdges[iy]);
+  return m_weights[bin];
+}
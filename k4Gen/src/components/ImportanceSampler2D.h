@@ -0,0 +1,40 @@
+#ifndef GENERATION_IMPORTANCESAMPLER2D_H
+#define GENERATION_IMPORTANCESAMPLER2D_H
+
+#include "AliasTable.h"
+
+#include <vector>
+
+/** @class ImportanceSampler2D
+ *
+ *  Draws two variables from a user-given density, binned in both, with an alias table over the bins and flat
+ *  values within a bin, so every draw is O(1). Every draw comes with the weight that turns the sampled
+ *  distribution back into a flat one over the binned range, so that weighted events estimate the same quantities as
+ *  flat sampling, with more events where the density is high. Bins with zero density are never drawn.
+ */
+class ImportanceSampler2D {
+public:
+  /** Set up the sampler.
+   *  @param[in] xEdges   increasing bin edges in x
+   *  @param[in] yEdges   increasing bin edges in y
+   *  @param[in] density  relative density per unit x and y in every bin, with index ix * (number of y bins) + iy
+   *  @return false if the binning and the density do not match, or the density is negative or zero everywhere
+   */
+  bool build(const std::vector<double>& xEdges, const std::vector<double>& yEdges, const std::vector<double>& density);
+
+  /** Draw a point from four uniform random numbers in [0, 1).
+   *  @param[out] x, y  the drawn values
+   *  @return the weight of the draw relative to a flat distribution over the binned range
+   */
+  double sample(double u1, double u2, double u3, double u4, double& x, double& y) const;
+
+  bool empty() const { return m_bins.size() == 0; }
+
+private:
+  AliasTable m_bins;
+  std::vector<double> m_xEdges;
+  std::vector<double> m_yEdges;
+  /// weight of the draws of every bin
+  std::vector<double> m_weights;
+};
+#endif
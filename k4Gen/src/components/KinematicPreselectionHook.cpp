@@ -0,0 +1,72 @@
+
+#include "KinematicPreselectionHook.h"
+#include "Pythia8/Pythia.h"
+
+#include <algorithm>
+
+using namespace Pythia8;
+
+//--------------------------------------------------------------------------
+bool KinematicPreselectionHook::initAfterBeams() {
+  filter_ = settingsPtr->flag("KinematicPreselection:filter");
+  ptMin_ = settingsPtr->parm("KinematicPreselection:ptMin");
+  absEtaMax_ = settingsPtr->parm("KinematicPreselection:absEtaMax");
+  mHatMin_ = settingsPtr->parm("KinematicPreselection:mHatMin");
+  nMin_ = settingsPtr->mode("KinematicPreselection:nMin");
+  nShowerSteps_ = settingsPtr->mode("KinematicPreselection:nShowerSteps");
+
+  pdgIds_.clear();
+  for (int id : settingsPtr->mvec("KinematicPreselection:pdgIds")) {
+    pdgIds_.push_back(std::abs(id));
+  }
+
+  nProcessChecked_ = 0;
+  nProcessVetoed_ = 0;
+  nStepVetoed_ = 0;
+
+  return true;
+}
+
+//--------------------------------------------------------------------------
+bool KinematicPreselectionHook::passCuts(const Event& event) const {
+  int nPass = 0;
+  for (int i = 0; i < event.size(); ++i) {
+    const Particle& p = event[i];
+    if (!p.isFinal())
+      continue;
+    if (!pdgIds_.empty() && std::find(pdgIds_.begin(), pdgIds_.end(), p.idAbs()) == pdgIds_.end())
+      continue;
+    if (p.pT() < ptMin_ || std::abs(p.eta()) > absEtaMax_)
+      continue;
+    // stop as soon as enough particles are found
+    if (++nPass >= nMin_)
+      return true;
+  }
+  return nPass >= nMin_;
+}
+
+//--------------------------------------------------------------------------
+bool KinematicPreselectionHook::doVetoProcessLevel(Event& process) {
+  ++nProcessChecked_;
+
+  if (infoPtr->mHat() < mHatMin_ || !passCuts(process)) {
+    ++nProcessVetoed_;
+    return true;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------
+bool KinematicPreselectionHook::doVetoStep(int, int nISR, int nFSR, const Event& event) {
+  // only apply the cuts once the requested number of shower steps is reached
+  if (nISR + nFSR < nShowerSteps_)
+    return false;
+
+  if (!passCuts(event)) {
+    ++nStepVetoed_;
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,58 @@
+#ifndef GENERATION_KINEMATICPRESELECTIONHOOK
+#define GENERATION_KINEMATICPRESELECTIONHOOK
+
+#include "Pythia8/Event.h"
+#include "Pythia8/UserHooks.h"
+
+#include <vector>
+
+/** @class KinematicPreselectionHook
+ *
+ *  Pythia8 user hook that vetoes events on simple kinematic cuts before the
+ *  expensive shower, MPI and hadronization steps are run: once after the hard
+ *  process and, optionally, again after the first N shower steps.
+ *  A particle passes if it is final in the record, its |PDG id| is in
+ *  KinematicPreselection:pdgIds (or the list is empty), and it satisfies the
+ *  pT and |eta| cuts. The event is vetoed if fewer than KinematicPreselection:nMin
+ *  particles pass or the hard-process invariant mass is below KinematicPreselection:mHatMin.
+ */
+class KinematicPreselectionHook : public Pythia8::UserHooks {
+public:
+  // Constructor and destructor.
+  KinematicPreselectionHook() {}
+
+  //--------------------------------------------------------------------------
+
+  bool initAfterBeams() override;
+  bool canVetoProcessLevel() override { return filter_; }
+  bool doVetoProcessLevel(Pythia8::Event& process) override;
+  bool canVetoStep() override { return filter_ && nShowerSteps_ > 0; }
+  int numberVetoStep() override { return nShowerSteps_; }
+  bool doVetoStep(int iPos, int nISR, int nFSR, const Pythia8::Event& event) override;
+
+  /// Number of hard processes seen by the hook
+  unsigned long nProcessChecked() const { return nProcessChecked_; }
+  /// Number of events vetoed after the hard process
+  unsigned long nProcessVetoed() const { return nProcessVetoed_; }
+  /// Number of events vetoed after the shower steps
+  unsigned long nStepVetoed() const { return nStepVetoed_; }
+
+  //--------------------------------------------------------------------------
+
+private:
+  /// Apply the configured cuts to the final particles of the record
+  bool passCuts(const Pythia8::Event& event) const;
+
+  bool filter_{false};
+  std::vector<int> pdgIds_;
+  double ptMin_{0.};
+  double absEtaMax_{0.};
+  double mHatMin_{0.};
+  int nMin_{0};
+  int nShowerSteps_{0};
+
+  unsigned long nProcessChecked_{0};
+  unsigned long nProcessVetoed_{0};
+  unsigned long nStepVetoed_{0};
+};
+#endif
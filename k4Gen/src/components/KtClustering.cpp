@@ -0,0 +1,122 @@
+
+#include "KtClustering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+//--------------------------------------------------------------------------
+void KtClustering::setMomentum(Cluster& cluster, const Pythia8::Vec4& p) const {
+  cluster.p = p;
+  cluster.pT2 = p.pT2();
+  cluster.y = p.rap();
+  cluster.phi = p.phi();
+}
+
+//--------------------------------------------------------------------------
+double KtClustering::distance2(const Cluster& a, const Cluster& b) const {
+  double dPhi = std::abs(a.phi - b.phi);
+  if (dPhi > M_PI)
+    dPhi = 2. * M_PI - dPhi;
+  double dY = a.y - b.y;
+  return dY * dY + dPhi * dPhi;
+}
+
+//--------------------------------------------------------------------------
+void KtClustering::findNearestNeighbour(int i) {
+  Cluster& cluster = m_clusters[i];
+  cluster.nn = -1;
+  cluster.nnDist = std::numeric_limits<double>::max();
+  for (int k = 0; k < int(m_clusters.size()); ++k) {
+    if (k == i)
+      continue;
+    double d = distance2(cluster, m_clusters[k]);
+    if (d < cluster.nnDist) {
+      cluster.nnDist = d;
+      cluster.nn = k;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------
+void KtClustering::analyze(const Pythia8::Event& event) {
+  m_clusters.clear();
+  m_scales.clear();
+  m_jetPts.clear();
+
+  // same selection as SlowJet with select = 2: visible final particles within the acceptance
+  for (int i = 0; i < event.size(); ++i) {
+    const Pythia8::Particle& particle = event[i];
+    if (!particle.isFinal() || !particle.isVisible() || std::abs(particle.eta()) > m_etaMax)
+      continue;
+    Cluster cluster;
+    setMomentum(cluster, particle.p());
+    m_clusters.push_back(cluster);
+  }
+  for (int i = 0; i < int(m_clusters.size()); ++i) {
+    findNearestNeighbour(i);
+  }
+
+  while (!m_clusters.empty()) {
+    // For kT, the smallest d_ij is always found between a cluster and its geometric nearest neighbour,
+    // so the cached neighbours are enough to find the next step.
+    int iMin = -1;
+    double dMin = std::numeric_limits<double>::max();
+    bool toBeam = false;
+    for (int i = 0; i < int(m_clusters.size()); ++i) {
+      const Cluster& cluster = m_clusters[i];
+      if (cluster.pT2 < dMin) {
+        dMin = cluster.pT2;
+        iMin = i;
+        toBeam = true;
+      }
+      if (cluster.nn >= 0) {
+        double dij = std::min(cluster.pT2, m_clusters[cluster.nn].pT2) * cluster.nnDist / m_R2;
+        if (dij < dMin) {
+          dMin = dij;
+          iMin = i;
+          toBeam = false;
+        }
+      }
+    }
+    m_scales.push_back(std::sqrt(dMin));
+
+    // Promote the cluster to a jet, or merge it with its neighbour into the lower of the two slots
+    int removed = iMin;
+    int merged = -1;
+    if (toBeam) {
+      if (m_clusters[iMin].pT2 > 0.)
+        m_jetPts.push_back(std::sqrt(m_clusters[iMin].pT2));
+    } else {
+      int j = m_clusters[iMin].nn;
+      merged = std::min(iMin, j);
+      removed = std::max(iMin, j);
+      setMomentum(m_clusters[merged], m_clusters[iMin].p + m_clusters[j].p);
+    }
+    const int last = int(m_clusters.size()) - 1;
+    m_clusters[removed] = m_clusters[last];
+    m_clusters.pop_back();
+
+    // Update the neighbours: recompute those that pointed to a removed or changed cluster,
+    // follow the cluster moved into the freed slot, and check the others against the merged cluster.
+    for (int k = 0; k < int(m_clusters.size()); ++k) {
+      Cluster& cluster = m_clusters[k];
+      if (k == merged || cluster.nn == removed || cluster.nn == merged) {
+        findNearestNeighbour(k);
+        continue;
+      }
+      if (cluster.nn == last)
+        cluster.nn = removed;
+      if (merged >= 0) {
+        double d = distance2(cluster, m_clusters[merged]);
+        if (d < cluster.nnDist) {
+          cluster.nnDist = d;
+          cluster.nn = merged;
+        }
+      }
+    }
+  }
+
+  std::sort(m_jetPts.begin(), m_jetPts.end(), std::greater<double>());
+}
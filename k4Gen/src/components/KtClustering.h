@@ -0,0 +1,57 @@
+#ifndef GENERATION_KTCLUSTERING
+#define GENERATION_KTCLUSTERING
+
+#include "Pythia8/Basics.h"
+#include "Pythia8/Event.h"
+
+#include <vector>
+
+/** @class KtClustering
+ *
+ *  Inclusive kT clustering of the visible final particles of a Pythia8 event, giving the same
+ *  clustering sequence as Pythia8::SlowJet(1, R, 0, etaMax, 2, 2) stepped until all clusters are jets.
+ *  Instead of searching the full distance matrix at every step, each cluster caches its geometric
+ *  nearest neighbour, which is only recomputed for the clusters affected by a step, so the cost is
+ *  O(N^2) instead of O(N^3). See BM_KtClustering and BM_SlowJet in k4GenBenchmarks for the comparison
+ *  with SlowJet.
+ */
+class KtClustering {
+public:
+  /** Constructor.
+   *  @param[in] R       jet radius
+   *  @param[in] etaMax  maximal |pseudorapidity| of the particles to cluster
+   */
+  KtClustering(double R, double etaMax) : m_R2(R * R), m_etaMax(etaMax) {}
+
+  /// Cluster the visible final particles of the event until all of them are assigned to jets
+  void analyze(const Pythia8::Event& event);
+
+  /// sqrt(d) of every clustering step, in the order the steps were done
+  const std::vector<double>& scales() const { return m_scales; }
+  /// Transverse momenta of the inclusive jets, in decreasing order
+  const std::vector<double>& jetPts() const { return m_jetPts; }
+
+private:
+  struct Cluster {
+    Pythia8::Vec4 p;
+    double pT2;
+    double y;
+    double phi;
+    /// index of the geometrically closest cluster, -1 if there is none
+    int nn;
+    /// (delta y)^2 + (delta phi)^2 to the nearest neighbour
+    double nnDist;
+  };
+
+  void setMomentum(Cluster& cluster, const Pythia8::Vec4& p) const;
+  double distance2(const Cluster& a, const Cluster& b) const;
+  void findNearestNeighbour(int i);
+
+  double m_R2;
+  double m_etaMax;
+  /// active clusters, reused between events
+  std::vector<Cluster> m_clusters;
+  std::vector<double> m_scales;
+  std::vector<double> m_jetPts;
+};
+#endif
@@ -0,0 +1,214 @@
+
+#include "LHEPrefetcher.h"
+
+#include <sstream>
+
+namespace {
+/// Whether the line opens the given LHE block, i.e. starts with "<tag>" or "<tag " after leading whitespace, so that
+/// e.g. the <initrwgt> block of the header does not match "init"
+bool opensBlock(const std::string& line, const std::string& tag) {
+  const auto start = line.find_first_not_of(" \t");
+  if (start == std::string::npos || line.compare(start, tag.size() + 1, "<" + tag) != 0)
+    return false;
+  const auto end = start + tag.size() + 1;
+  return end == line.size() || line[end] == '>' || line[end] == ' ' || line[end] == '\t' || line[end] == '\r';
+}
+} // namespace
+
+//--------------------------------------------------------------------------
+LHEPrefetcher::LHEPrefetcher(const std::vector<std::string>& files, long firstEvent, long maxEvents,
+                             unsigned int capacity)
+    : m_files(files), m_firstEvent(firstEvent), m_maxEvents(maxEvents), m_capacity(capacity > 0 ? capacity : 1) {}
+
+//--------------------------------------------------------------------------
+LHEPrefetcher::~LHEPrefetcher() { stop(); }
+
+//--------------------------------------------------------------------------
+void LHEPrefetcher::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_notFull.notify_all();
+  if (m_producer.joinable())
+    m_producer.join();
+  if (m_file != nullptr) {
+    gzclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+//--------------------------------------------------------------------------
+std::string LHEPrefetcher::errorMessage() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_error;
+}
+
+//--------------------------------------------------------------------------
+void LHEPrefetcher::fail(const std::string& message) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_error = message;
+}
+
+//--------------------------------------------------------------------------
+bool LHEPrefetcher::nextLine(std::string& line) {
+  char buffer[4096];
+  line.clear();
+  while (m_iFile < m_files.size()) {
+    if (m_file == nullptr) {
+      // gzopen reads uncompressed files transparently
+      m_file = gzopen(m_files[m_iFile].c_str(), "rb");
+      if (m_file == nullptr) {
+        fail("Cannot open LHE file " + m_files[m_iFile]);
+        m_iFile = m_files.size();
+        return false;
+      }
+      gzbuffer(m_file, 1 << 20);
+    }
+    // lines longer than the buffer are read in several pieces
+    while (gzgets(m_file, buffer, sizeof(buffer)) != nullptr) {
+      line += buffer;
+      if (line.back() == '\n') {
+        line.pop_back();
+        return true;
+      }
+    }
+    if (!line.empty())
+      return true;
+    gzclose(m_file);
+    m_file = nullptr;
+    ++m_iFile;
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------
+bool LHEPrefetcher::setInit() {
+  if (m_files.empty()) {
+    fail("No LHE files given");
+    return false;
+  }
+
+  // the init block of the first file describes the whole stream
+  std::string line;
+  while (nextLine(line) && !opensBlock(line, "init")) {
+  }
+  if (!nextLine(line)) {
+    fail("No init block found in " + m_files.front());
+    return false;
+  }
+
+  int idBeamA, idBeamB, pdfGroupA, pdfGroupB, pdfSetA, pdfSetB, strategy, nProcesses;
+  double eBeamA, eBeamB;
+  std::istringstream beams(line);
+  if (!(beams >> idBeamA >> idBeamB >> eBeamA >> eBeamB >> pdfGroupA >> pdfGroupB >> pdfSetA >> pdfSetB >> strategy >>
+        nProcesses)) {
+    fail("Malformed init block in " + m_files.front());
+    return false;
+  }
+  setBeamA(idBeamA, eBeamA, pdfGroupA, pdfSetA);
+  setBeamB(idBeamB, eBeamB, pdfGroupB, pdfSetB);
+  setStrategy(strategy);
+
+  for (int i = 0; i < nProcesses; ++i) {
+    double xSec, xErr, xMax;
+    int idProc;
+    std::istringstream process;
+    if (nextLine(line))
+      process.str(line);
+    if (!(process >> xSec >> xErr >> xMax >> idProc)) {
+      fail("Malformed process line in init block of " + m_files.front());
+      return false;
+    }
+    addProcess(idProc, xSec, xErr, xMax);
+  }
+
+  m_producer = std::thread(&LHEPrefetcher::produce, this);
+  return true;
+}
+
+//--------------------------------------------------------------------------
+bool LHEPrefetcher::parseEvent(Event& event) {
+  std::string line;
+  int nParticles = 0;
+  std::istringstream header;
+  if (nextLine(line))
+    header.str(line);
+  if (!(header >> nParticles >> event.idProc >> event.weight >> event.scale >> event.alphaQED >> event.alphaQCD))
+    return false;
+
+  event.particles.resize(nParticles);
+  for (auto& p : event.particles) {
+    std::istringstream entry;
+    if (nextLine(line))
+      entry.str(line);
+    if (!(entry >> p.id >> p.status >> p.mother1 >> p.mother2 >> p.col1 >> p.col2 >> p.px >> p.py >> p.pz >> p.e >>
+          p.m >> p.tau >> p.spin))
+      return false;
+  }
+
+  // skip optional information (weights, comments) up to the end of the event block
+  while (nextLine(line)) {
+    if (line.find("</event>") != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------
+void LHEPrefetcher::produce() {
+  std::string line;
+  long iEvent = 0;
+  while (!m_stop && (m_maxEvents < 0 || iEvent < m_firstEvent + m_maxEvents) && nextLine(line)) {
+    if (!opensBlock(line, "event"))
+      continue;
+
+    // events before the requested range are only scanned, not parsed
+    if (iEvent++ < m_firstEvent) {
+      while (!m_stop && nextLine(line) && line.find("</event>") == std::string::npos) {
+      }
+      continue;
+    }
+
+    Event event;
+    if (!parseEvent(event)) {
+      fail("Malformed event " + std::to_string(iEvent - 1) + " in the LHE input");
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] { return m_stop || m_queue.size() < m_capacity; });
+    m_queue.push_back(std::move(event));
+    lock.unlock();
+    m_notEmpty.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_done = true;
+  }
+  m_notEmpty.notify_all();
+}
+
+//--------------------------------------------------------------------------
+bool LHEPrefetcher::setEvent(int) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_queue.empty() && !m_done)
+    ++m_nStalls;
+  m_notEmpty.wait(lock, [this] { return m_done || !m_queue.empty(); });
+  if (m_queue.empty()) {
+    // end of the event stream or of the requested event range
+    return false;
+  }
+  Event event = std::move(m_queue.front());
+  m_queue.pop_front();
+  lock.unlock();
+  m_notFull.notify_one();
+
+  setProcess(event.idProc, event.weight, event.scale, event.alphaQED, event.alphaQCD);
+  for (const auto& p : event.particles) {
+    addParticle(p.id, p.status, p.mother1, p.mother2, p.col1, p.col2, p.px, p.py, p.pz, p.e, p.m, p.tau, p.spin);
+  }
+  ++m_nProvided;
+  return true;
+}
@@ -0,0 +1,90 @@
+#ifndef GENERATION_LHEPREFETCHER
+#define GENERATION_LHEPREFETCHER
+
+#include "Pythia8/LesHouches.h"
+
+#include <zlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** @class LHEPrefetcher
+ *
+ *  Les Houches interface feeding Pythia8 from a list of (optionally gzipped) LHE files.
+ *  The files are read as one continuous event stream: the init block is taken from the first file,
+ *  events are decompressed and parsed on a background thread into a bounded in-memory queue, and
+ *  only the events in [firstEvent, firstEvent + maxEvents) of the stream are handed to Pythia,
+ *  which allows to shard large samples over many jobs.
+ */
+class LHEPrefetcher : public Pythia8::LHAup {
+public:
+  /** Constructor.
+   *  @param[in] files       LHE files to read, in order
+   *  @param[in] firstEvent  number of events to skip at the start of the stream
+   *  @param[in] maxEvents   maximal number of events to provide, negative means all
+   *  @param[in] capacity    maximal number of parsed events kept in memory
+   */
+  LHEPrefetcher(const std::vector<std::string>& files, long firstEvent, long maxEvents, unsigned int capacity);
+  ~LHEPrefetcher();
+
+  //--------------------------------------------------------------------------
+
+  bool setInit() override;
+  bool setEvent(int idProcIn = 0) override;
+
+  /// Stop the background thread and close the input; no further events are provided
+  void stop();
+
+  /// Number of events handed to Pythia
+  unsigned long nEventsProvided() const { return m_nProvided; }
+  /// Number of times Pythia had to wait for the background thread
+  unsigned long nStalls() const { return m_nStalls; }
+  /// Description of the last read error, empty if there was none
+  std::string errorMessage() const;
+
+  //--------------------------------------------------------------------------
+
+private:
+  struct Particle {
+    int id, status, mother1, mother2, col1, col2;
+    double px, py, pz, e, m, tau, spin;
+  };
+  struct Event {
+    int idProc;
+    double weight, scale, alphaQED, alphaQCD;
+    std::vector<Particle> particles;
+  };
+
+  /// Read the next line of the event stream, moving on to the next file at the end of the current one
+  bool nextLine(std::string& line);
+  /// Background thread: parse events into the queue until the stream or the event range is exhausted
+  void produce();
+  /// Parse the body of an event block, the current line being the opening event tag
+  bool parseEvent(Event& event);
+  void fail(const std::string& message);
+
+  std::vector<std::string> m_files;
+  unsigned int m_iFile{0};
+  gzFile m_file{nullptr};
+  long m_firstEvent;
+  long m_maxEvents;
+  unsigned int m_capacity;
+
+  std::thread m_producer;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+  std::deque<Event> m_queue;
+  bool m_done{false};
+  std::atomic<bool> m_stop{false};
+  std::string m_error;
+
+  unsigned long m_nProvided{0};
+  unsigned long m_nStalls{0};
+};
+#endif
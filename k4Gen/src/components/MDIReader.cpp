@@ -25,6 +25,7 @@ MDIReader::MDIReader(const std::string& name, ISvcLocator* svcLoc) : Gaudi::Algo
 
 StatusCode MDIReader::initialize() {
   StatusCode sc = Gaudi::Algorithm::initialize();
+  m_timeStages = m_monitorStages || !m_stageSummaryFile.empty();
 
   debug() << "Reading file: " << m_filename << endmsg;
 
@@ -38,6 +39,8 @@ StatusCode MDIReader::initialize() {
 }
 
 StatusCode MDIReader::execute(const EventContext&) const {
+  StageTimer timer(m_time, m_timeStages);
+
   // First check the input file status
   if (m_input.eof()) {
     error() << "End of file reached" << endmsg;
@@ -52,6 +55,19 @@ StatusCode MDIReader::execute(const EventContext&) const {
     debug() << "Selected input type : " << input_type << endmsg;
   }
 
+  debug() << "The crossing angle is " << xing << " [rad]" << endmsg;
+  edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
+  if (readParticles(m_input, *particles).isFailure()) {
+    delete particles;
+    return StatusCode::FAILURE;
+  }
+
+  m_numParticles += particles->size();
+  m_genphandle.put(particles);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode MDIReader::readParticles(std::istream& input, edm4hep::MCParticleCollection& particles) const {
   //  Loop over particles
   int ISTHEP = 1; // status code
   int IDHEP = 0;  // PDG code
@@ -76,22 +92,19 @@ StatusCode MDIReader::execute(const EventContext&) const {
   double id_ee;   // same id means they are a pair
   double temp_x, temp_z, temp_px, temp_pz, temp_e;
 
-  debug() << "The crossing angle is " << xing << " [rad]" << endmsg;
   // std::cout <<"The crossing angle is "<<xing<<" [rad]"<< endmsg;
-  edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
-
   size_t pcount = 0;
   PHEP5 = 5.11e-4;
-  while (m_input.good()) {
+  while (input.good()) {
     if (input_type == "guineapig") {
-      m_input >> PHEP4 >> PHEP1 >> PHEP2 >> PHEP3 >> VHEP1 >> VHEP2 >> VHEP3 >> process >> trash >> id_ee;
+      input >> PHEP4 >> PHEP1 >> PHEP2 >> PHEP3 >> VHEP1 >> VHEP2 >> VHEP3 >> process >> trash >> id_ee;
 
       // std::cout<<PHEP4<<" "<<sqrt(PHEP1*PHEP1 + PHEP2*PHEP2 + PHEP3*PHEP3)<<" "<<sqrt((PHEP1*PHEP1 + PHEP2*PHEP2 +
       // PHEP3*PHEP3)*PHEP4*PHEP4 + PHEP5*PHEP5)<<std::endl;
 
-      if (m_input.eof())
+      if (input.eof())
         break;
-      else if (!m_input.good()) {
+      else if (!input.good()) {
         debug() << "End of file reached before reading all the hits" << endmsg;
         error() << "End of file reached before reading all the hits" << endmsg;
         return StatusCode::FAILURE;
@@ -134,11 +147,11 @@ StatusCode MDIReader::execute(const EventContext&) const {
     } // end if guineapig
 
     else if (input_type == "xtrack") {
-      m_input >> VHEP3 >> VHEP1 >> VHEP2 >> PHEP1 >> PHEP2 >> temp_z >> PHEP4;
+      input >> VHEP3 >> VHEP1 >> VHEP2 >> PHEP1 >> PHEP2 >> temp_z >> PHEP4;
 
-      if (m_input.eof())
+      if (input.eof())
         break;
-      else if (!m_input.good()) {
+      else if (!input.good()) {
         debug() << "End of file reached before reading all the hits" << endmsg;
         error() << "End of file reached before reading all the hits" << endmsg;
         return StatusCode::FAILURE;
@@ -172,7 +185,7 @@ StatusCode MDIReader::execute(const EventContext&) const {
 
     } // end if xtrack
 
-    edm4hep::MutableMCParticle particle = particles->create();
+    edm4hep::MutableMCParticle particle = particles.create();
 
     particle.setPDG(IDHEP);
     particle.setCharge(CHARGE);
@@ -203,11 +216,15 @@ StatusCode MDIReader::execute(const EventContext&) const {
             << ", z = " << particle.getVertex().z << " mm" << endmsg;
   }
 
-  m_genphandle.put(particles);
   return StatusCode::SUCCESS;
 }
 
 StatusCode MDIReader::finalize() {
+  if (!m_stageSummaryFile.empty()) {
+    if (!writeStageSummary(m_stageSummaryFile, name(), m_time,
+                           {{"time read [ms]", &m_time}, {"particles", &m_numParticles}}))
+      warning() << "Could not write the stage summary to " << m_stageSummaryFile.value() << endmsg;
+  }
   m_input.close();
   debug() << "MDIReader finalization" << endmsg;
   return Gaudi::Algorithm::finalize();
@@ -12,6 +12,8 @@
 
 #include "GaudiKernel/SystemOfUnits.h"
 
+#include "StageMonitor.h"
+
 #include "HepMC3/GenEvent.h"
 #include "HepMC3/ReaderAscii.h"
 
@@ -39,6 +41,8 @@ public:
   virtual StatusCode execute(const EventContext&) const;
   /// Finalize.
   virtual StatusCode finalize();
+  /// Read all particles remaining in the input into the collection, converting them to the detector frame
+  StatusCode readParticles(std::istream& input, edm4hep::MCParticleCollection& particles) const;
 
 private:
   std::string m_filename;
@@ -50,6 +54,15 @@ private:
   /// Handle for the genparticles to be written
   mutable k4FWCore::DataHandle<edm4hep::MCParticleCollection> m_genphandle{"GenParticles", Gaudi::DataHandle::Writer, this};
 
+  /// Switch for the read timer
+  Gaudi::Property<bool> m_monitorStages{this, "monitorStages", false, "Time the reading of every event"};
+  /// JSON summary of the timer and counters written at finalize, enables the timer
+  Gaudi::Property<std::string> m_stageSummaryFile{this, "stageSummaryFile", "",
+                                                  "File for a JSON summary of the timer and counters"};
+  bool m_timeStages{false};
+  mutable Gaudi::Accumulators::StatCounter<double> m_time{this, "time read [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numParticles{this, "particles"};
+
   /// Tools to handle input from HepMC-file
   ToolHandle<IHepMCFileReaderTool> m_signalFileReader;
   ToolHandle<IHepMCFileReaderTool> m_pileupFileReader;
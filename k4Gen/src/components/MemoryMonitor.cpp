@@ -0,0 +1,54 @@
+
+#include "MemoryMonitor.h"
+
+#include <dlfcn.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+
+//--------------------------------------------------------------------------
+const AllocationHook* AllocationHook::find() {
+  static const AllocationHook* hook = []() -> const AllocationHook* {
+    auto threadAllocations = reinterpret_cast<ThreadAllocationsFunction>(dlsym(RTLD_DEFAULT, "k4GenThreadAllocations"));
+    auto threadHeap = reinterpret_cast<ThreadHeapFunction>(dlsym(RTLD_DEFAULT, "k4GenThreadHeap"));
+    auto setThreadHeapPeak =
+        reinterpret_cast<SetThreadHeapPeakFunction>(dlsym(RTLD_DEFAULT, "k4GenSetThreadHeapPeak"));
+    if (threadAllocations == nullptr || threadHeap == nullptr || setThreadHeapPeak == nullptr)
+      return nullptr;
+    return new AllocationHook(threadAllocations, threadHeap, setThreadHeapPeak);
+  }();
+  return hook;
+}
+
+//--------------------------------------------------------------------------
+double peakRssMB() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.;
+  // ru_maxrss is in kB on Linux
+  return usage.ru_maxrss / 1024.;
+}
+
+//--------------------------------------------------------------------------
+StageMemory::StageMemory(StageMemoryTotals& totals, const AllocationHook* hook) : m_totals(totals), m_hook(hook) {
+  if (m_hook == nullptr)
+    return;
+  m_hook->threadAllocations(m_allocations, m_bytes);
+  // follow the high-water mark of this scope from the current heap of the thread
+  m_hook->threadHeap(m_heapBytes, m_outerHeapPeakBytes);
+  m_hook->setThreadHeapPeak(m_heapBytes);
+}
+
+//--------------------------------------------------------------------------
+StageMemory::~StageMemory() {
+  if (m_hook == nullptr)
+    return;
+  unsigned long allocations, bytes;
+  m_hook->threadAllocations(allocations, bytes);
+  m_totals.allocations += allocations - m_allocations;
+  m_totals.bytes += bytes - m_bytes;
+  long heapBytes, heapPeakBytes;
+  m_hook->threadHeap(heapBytes, heapPeakBytes);
+  m_totals.peakHeapBytes = std::max(m_totals.peakHeapBytes, heapPeakBytes - m_heapBytes);
+  m_hook->setThreadHeapPeak(std::max(m_outerHeapPeakBytes, heapPeakBytes));
+}
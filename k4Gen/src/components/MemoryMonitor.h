@@ -0,0 +1,105 @@
+#ifndef GENERATION_MEMORYMONITOR_H
+#define GENERATION_MEMORYMONITOR_H
+
+#include "Gaudi/Accumulators.h"
+
+#include "StageMonitor.h"
+
+#include <string>
+
+/** @class AllocationHook
+ *
+ *  Access to the counters of the allocation hook library (libk4GenAllocationHook.so), which replaces the global
+ *  operator new and delete when it is preloaded into the job. Without the preload there are no counters.
+ */
+class AllocationHook {
+public:
+  /// The hook of this process, nullptr if the library is not preloaded
+  static const AllocationHook* find();
+
+  /// Number of allocations and allocated bytes of the calling thread since it started
+  void threadAllocations(unsigned long& allocations, unsigned long& bytes) const {
+    m_threadAllocations(&allocations, &bytes);
+  }
+  /// Heap held by the calling thread in bytes (allocated minus freed by it) and its high-water mark
+  void threadHeap(long& bytes, long& peakBytes) const { m_threadHeap(&bytes, &peakBytes); }
+  /// Restart the high-water mark of the heap held by the calling thread from the given value
+  void setThreadHeapPeak(long peakBytes) const { m_setThreadHeapPeak(peakBytes); }
+
+private:
+  using ThreadAllocationsFunction = void (*)(unsigned long*, unsigned long*);
+  using ThreadHeapFunction = void (*)(long*, long*);
+  using SetThreadHeapPeakFunction = void (*)(long);
+  AllocationHook(ThreadAllocationsFunction threadAllocations, ThreadHeapFunction threadHeap,
+                 SetThreadHeapPeakFunction setThreadHeapPeak)
+      : m_threadAllocations(threadAllocations), m_threadHeap(threadHeap), m_setThreadHeapPeak(setThreadHeapPeak) {}
+
+  ThreadAllocationsFunction m_threadAllocations;
+  ThreadHeapFunction m_threadHeap;
+  SetThreadHeapPeakFunction m_setThreadHeapPeak;
+};
+
+/// Peak resident set size of the process in MB
+double peakRssMB();
+
+/// Allocations of one processing stage within an event, which may be done in several pieces
+struct StageMemoryTotals {
+  unsigned long allocations{0};
+  unsigned long bytes{0};
+  /// largest growth of the heap held by the thread over its size at the start of a piece of the stage
+  long peakHeapBytes{0};
+};
+
+/// Gaudi counters of the allocations of one processing stage
+struct StageMemoryCounters {
+  template <typename OWNER>
+  StageMemoryCounters(OWNER* owner, const std::string& stage)
+      : stage(stage), allocations{owner, "allocations " + stage}, allocatedMB{owner, "allocated " + stage + " [MB]"},
+        peakHeapMB{owner, "peak heap " + stage + " [MB]"} {}
+
+  /// Add the allocations of one event
+  void fill(const StageMemoryTotals& totals) {
+    allocations += totals.allocations;
+    allocatedMB += totals.bytes / (1024. * 1024.);
+    peakHeapMB += totals.peakHeapBytes / (1024. * 1024.);
+  }
+
+  /// Append the counters to those of a stage summary
+  void addTo(StageCounters& counters) const {
+    counters.emplace_back("allocations " + stage, &allocations);
+    counters.emplace_back("allocated " + stage + " [MB]", &allocatedMB);
+    counters.emplace_back("peak heap " + stage + " [MB]", &peakHeapMB);
+  }
+
+  std::string stage;
+
+  Gaudi::Accumulators::StatCounter<double> allocations;
+  Gaudi::Accumulators::StatCounter<double> allocatedMB;
+  /// Per thread, so that it does not include what the stages of concurrent events hold at the same time
+  Gaudi::Accumulators::StatCounter<double> peakHeapMB;
+};
+
+/** @class StageMemory
+ *
+ *  Allocations done by the calling thread while the object is in scope, and the largest growth of the heap held by
+ *  the thread over that time, added to the stage totals when it goes out of scope. Scopes may be nested. Does nothing
+ *  without an allocation hook.
+ */
+class StageMemory {
+public:
+  StageMemory(StageMemoryTotals& totals, const AllocationHook* hook);
+  ~StageMemory();
+  StageMemory(const StageMemory&) = delete;
+  StageMemory& operator=(const StageMemory&) = delete;
+
+private:
+  StageMemoryTotals& m_totals;
+  const AllocationHook* m_hook;
+  unsigned long m_allocations{0};
+  unsigned long m_bytes{0};
+  long m_heapBytes{0};
+  /// high-water mark of the enclosing scope, restored at the end
+  long m_outerHeapPeakBytes{0};
+};
+
+#endif // GENERATION_MEMORYMONITOR_H
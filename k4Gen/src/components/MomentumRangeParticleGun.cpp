@@ -1,4 +1,6 @@
 #include "MomentumRangeParticleGun.h"
+#include "ParticleGunBatch.h"
+#include "ParticleProperties.h"
 
 #include <cmath>
 
@@ -9,8 +11,6 @@
 #include "HepMC3/GenEvent.h"
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
-#include "HepPDT/ParticleID.hh"
-#include "Pythia8/ParticleData.h"
 
 DECLARE_COMPONENT(MomentumRangeParticleGun)
 
@@ -50,15 +50,23 @@ StatusCode MomentumRangeParticleGun::initialize() {
   m_deltaPhi = m_maxPhi - m_minPhi;
   m_deltaTheta = m_maxTheta - m_minTheta;
 
+  if (!m_importanceDensity.empty()) {
+    if (!m_importanceSampler.build(m_importanceMomentumEdges, m_importanceThetaEdges, m_importanceDensity)) {
+      error() << "Inconsistent importance sampling binning or density" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Importance sampling of momentum and theta in " << m_importanceDensity.size() << " bins" << endmsg;
+  }
+
   // setup particle information
   m_masses.clear();
-  auto pd = Pythia8::ParticleData();
+  const auto& particleProperties = ParticleProperties::instance();
 
   info() << "Particle type chosen randomly from :";
   PIDs::iterator icode;
   for (icode = m_pdgCodes.begin(); icode != m_pdgCodes.end(); ++icode) {
     info() << " " << *icode;
-    m_masses.push_back(pd.m0(*icode));
+    m_masses.push_back(particleProperties.mass(*icode) * Gaudi::Units::GeV);
   }
 
   info() << endmsg;
@@ -70,6 +78,7 @@ StatusCode MomentumRangeParticleGun::initialize() {
   info() << "Phi range: " << m_minPhi / Gaudi::Units::rad << " rad <-> " << m_maxPhi / Gaudi::Units::rad << " rad"
          << endmsg;
 
+  m_buffer.clear();
   return sc;
 }
 
@@ -84,6 +93,11 @@ void MomentumRangeParticleGun::generateParticle(Gaudi::LorentzVector& momentum,
   double p = m_minMom + m_flatGenerator() * (m_deltaMom);
   double theta = m_minTheta + m_flatGenerator() * (m_deltaTheta);
   double phi = m_minPhi + m_flatGenerator() * (m_deltaPhi);
+  m_weight = 1.;
+  if (!m_importanceSampler.empty()) {
+    const double u1 = m_flatGenerator(), u2 = m_flatGenerator(), u3 = m_flatGenerator(), u4 = m_flatGenerator();
+    m_weight = m_importanceSampler.sample(u1, u2, u3, u4, p, theta);
+  }
 
   // Transform to x,y,z coordinates
   double pt = p * sin(theta);
@@ -107,12 +121,50 @@ void MomentumRangeParticleGun::generateParticle(Gaudi::LorentzVector& momentum,
   debug() << " -> " << pdgId << endmsg << "   P   = " << momentum << endmsg;
 }
 
+/// Generate a batch of particles
+void MomentumRangeParticleGun::generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds) {
+  if (!m_importanceSampler.empty()) {
+    // the weights of importance-sampled particles are only kept in the events of getNextEvent
+    momenta.resize(n);
+    origins.resize(n);
+    pdgIds.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+      generateParticle(momenta[i], origins[i], pdgIds[i]);
+    return;
+  }
+  origins.assign(n, Gaudi::LorentzVector(0., 0., 0., 0.));
+  // one block of uniform numbers for momentum, theta, phi and the particle type
+  m_flatGenerator.shootArray(m_uniforms, 4 * n).ignore();
+  double* p = m_uniforms.data();
+  double* theta = p + n;
+  double* phi = theta + n;
+  const double* type = phi + n;
+  ParticleGunBatch::flat(p, n, m_minMom, m_deltaMom);
+  ParticleGunBatch::flat(theta, n, m_minTheta, m_deltaTheta);
+  ParticleGunBatch::flat(phi, n, m_minPhi, m_deltaPhi);
+  // masses and the cartesian components
+  m_scratch.resize(5 * n);
+  double* mass = m_scratch.data();
+  ParticleGunBatch::particleTypes(type, n, m_pdgCodes, m_masses, pdgIds, mass);
+  ParticleGunBatch::momentaFromPThetaPhi(n, p, theta, phi, mass, mass + n, mass + 2 * n, mass + 3 * n, mass + 4 * n,
+                                         momenta);
+}
+
 StatusCode MomentumRangeParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
   Gaudi::LorentzVector theFourMomentum;
   Gaudi::LorentzVector origin;
   // note: pgdid is set in function generateParticle
   int thePdgId;
-  generateParticle(theFourMomentum, origin, thePdgId);
+  if (m_batchSize > 1 && m_importanceSampler.empty()) {
+    if (m_buffer.empty()) {
+      generateParticles(m_batchSize, m_buffer.momenta, m_buffer.origins, m_buffer.pdgIds);
+      m_buffer.next = 0;
+    }
+    m_buffer.pop(theFourMomentum, origin, thePdgId);
+  } else {
+    generateParticle(theFourMomentum, origin, thePdgId);
+  }
 
   // create HepMC3 Vertex --
   // by calling add_vertex(), the hepmc event is given ownership of the vertex
@@ -131,6 +183,12 @@ StatusCode MomentumRangeParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
   v->add_particle_out(p);
 
   theEvent.add_vertex(v);
+  if (!m_importanceSampler.empty()) {
+    if (theEvent.weights().empty())
+      theEvent.weights().push_back(m_weight);
+    else
+      theEvent.weights()[0] *= m_weight;
+  }
   // no longer needed in hepmc3
   // theEvent.set_signal_process_vertex(v);
 
@@ -8,9 +8,13 @@
 
 #include "Generation/IParticleGunTool.h"
 
+#include "ImportanceSampler2D.h"
+#include "ParticleGunBatch.h"
+
 /** @class MomentumRangeParticleGun MomentumRangeParticleGun.h "MomentumRangeParticleGun.h"
  *
- *  Particle gun with given momentum range
+ *  Particle gun with given momentum range. With importanceDensity, momentum and theta are drawn from a binned
+ *  density instead, and the weight of the particle is stored as event weight.
  *
  *  @author Patrick Robbe (adaptation to tool structure)
  *  @author Benedikt Hegner (adaption for non LHCb use cases)
@@ -32,6 +36,10 @@ public:
   /// Generation of particles
   virtual void generateParticle(Gaudi::LorentzVector& momentum, Gaudi::LorentzVector& origin, int& pdgId);
 
+  /// Generation of a batch of particles
+  virtual void generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds);
+
   /// Print counters
   virtual void printCounters() { ; };
   virtual StatusCode getNextEvent(HepMC3::GenEvent&);
@@ -58,6 +66,24 @@ private:
   /// Phi range
   double m_deltaPhi;
 
+  /// Importance sampling of momentum and theta (Set by options)
+  Gaudi::Property<std::vector<double>> m_importanceMomentumEdges{
+      this, "importanceMomentumEdges", {}, "Bin edges in momentum of the importance sampling density"};
+  Gaudi::Property<std::vector<double>> m_importanceThetaEdges{
+      this, "importanceThetaEdges", {}, "Bin edges in theta of the importance sampling density"};
+  Gaudi::Property<std::vector<double>> m_importanceDensity{
+      this,
+      "importanceDensity",
+      {},
+      "Relative density in every momentum and theta bin (index iMomentum * number of theta bins + iTheta). If given, "
+      "momentum and theta are drawn from it instead of flat, and the event gets the weight that restores a flat "
+      "distribution"};
+
+  /// Number of particles generated ahead and served one per event (Set by options)
+  Gaudi::Property<unsigned int> m_batchSize{
+      this, "batchSize", 1,
+      "Number of particles generated ahead in one batch and served one per event; 1 generates every particle on its "
+      "own. Not used with importance sampling"};
   /// Pdg Codes of particles to generate (Set by options)
   Gaudi::Property<std::vector<int>> m_pdgCodes{this, "PdgCodes", {-211}, "list of pdg codes to produce"};
 
@@ -69,6 +95,16 @@ private:
 
   /// Flat random number generator
   Rndm::Numbers m_flatGenerator;
+
+  /// Importance sampling of momentum and theta, and the weight of the last generated particle
+  ImportanceSampler2D m_importanceSampler;
+  double m_weight{1.};
+
+  /// Uniform random numbers and scratch space of the batch generation, reused between batches
+  std::vector<double> m_uniforms;
+  std::vector<double> m_scratch;
+  /// Particles generated ahead for getNextEvent
+  ParticleGunBatch::Buffer m_buffer;
 };
 
 #endif // GENERATION_MOMENTUMRANGEPARTICLEGUN_H
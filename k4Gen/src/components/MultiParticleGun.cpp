@@ -0,0 +1,266 @@
+#include "MultiParticleGun.h"
+#include "ParticleGunBatch.h"
+#include "ParticleProperties.h"
+#include "GaudiKernel/IRndmGenSvc.h"
+#include "GaudiKernel/PhysicalConstants.h"
+#include "GaudiKernel/SystemOfUnits.h"
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+#include <algorithm>
+#include <cmath>
+
+DECLARE_COMPONENT(MultiParticleGun)
+
+MultiParticleGun::MultiParticleGun(const std::string& type, const std::string& name, const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<IParticleGunTool>(this);
+}
+
+MultiParticleGun::~MultiParticleGun() {}
+
+StatusCode MultiParticleGun::initialize() {
+  StatusCode sc = AlgTool::initialize();
+  if (!sc.isSuccess())
+    return sc;
+  // initialize random number generators
+  auto randSvc = service<IRndmGenSvc>("RndmGenSvc", true);
+  sc = m_flatGenerator.initialize(randSvc, Rndm::Flat(0., 1.));
+  if (!sc.isSuccess()) {
+    error() << "Cannot initialize flat generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_multiplicity == "Poisson") {
+    if (m_numParticles < 0) {
+      error() << "Mean number of particles cannot be negative!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    sc = m_poissonGenerator.initialize(randSvc, Rndm::Poisson(m_numParticles));
+    if (!sc.isSuccess()) {
+      error() << "Cannot initialize Poisson generator" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  } else if (m_multiplicity == "Range") {
+    if (m_minNumParticles > m_maxNumParticles) {
+      error() << "Incorrect range for the number of particles!" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  } else if (m_multiplicity != "Fixed") {
+    error() << "Unknown multiplicity " << m_multiplicity.value() << ", use Fixed, Poisson or Range" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // check momentum, angles and vertex box
+  if ((m_minEta > m_maxEta) || (m_minPhi > m_maxPhi) || (m_minPt > m_maxPt)) {
+    error() << "Incorrect values for pt, eta or phi!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if ((m_xmin > m_xmax) || (m_ymin > m_ymax) || (m_zmin > m_zmax)) {
+    error() << "Incorrect values for the vertex box!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_deltaPhi = m_maxPhi - m_minPhi;
+  m_deltaEta = m_maxEta - m_minEta;
+  // setup particle information
+  m_masses.clear();
+  const auto& particleProperties = ParticleProperties::instance();
+  info() << "Particle type chosen randomly from :";
+  for (auto code : m_pdgCodes) {
+    info() << " " << code;
+    m_masses.push_back(particleProperties.mass(code) * Gaudi::Units::GeV);
+  }
+  info() << endmsg;
+  info() << "Number of particles per event: " << m_multiplicity.value() << " ";
+  if (m_multiplicity == "Range")
+    info() << m_minNumParticles << " <-> " << m_maxNumParticles << endmsg;
+  else
+    info() << m_numParticles << endmsg;
+  info() << "Eta range: " << m_minEta << "  <-> " << m_maxEta << endmsg;
+  info() << "Phi range: " << m_minPhi / Gaudi::Units::rad << " rad <-> " << m_maxPhi / Gaudi::Units::rad << " rad"
+         << endmsg;
+  if (m_isolationDeltaR > 0)
+    info() << "Minimal eta-phi distance between particles: " << m_isolationDeltaR << endmsg;
+  // write additional output
+  if (m_writeParticleGunBranches) {
+    m_particleGunBranches.declare(this);
+  }
+  return sc;
+}
+
+unsigned int MultiParticleGun::numberOfParticles() {
+  if (m_multiplicity == "Poisson")
+    return m_poissonGenerator();
+  if (m_multiplicity == "Range") {
+    unsigned int n = m_minNumParticles + m_flatGenerator() * (m_maxNumParticles - m_minNumParticles + 1);
+    return std::min(n, m_maxNumParticles.value());
+  }
+  return m_numParticles;
+}
+
+void MultiParticleGun::generateDirection(double& eta, double& phi) {
+  phi = m_minPhi + m_flatGenerator() * (m_deltaPhi);
+  eta = m_minEta + m_flatGenerator() * (m_deltaEta);
+}
+
+void MultiParticleGun::generateMomentum(double eta, double phi, Gaudi::LorentzVector& momentum, int& pdgId) {
+  double pt = m_minPt + m_flatGenerator() * (m_maxPt - m_minPt);
+  if (m_logSpacedPt) {
+    pt = pow(10, std::log10(m_minPt) + (std::log10(m_maxPt) - std::log10(m_minPt)) * m_flatGenerator());
+  }
+  // randomly choose a particle type
+  unsigned int currentType = (unsigned int)(m_pdgCodes.size() * m_flatGenerator());
+  // protect against funnies
+  if (currentType >= m_pdgCodes.size())
+    currentType = 0;
+  momentum.SetPx(pt * cos(phi));
+  momentum.SetPy(pt * sin(phi));
+  momentum.SetPz(pt * sinh(eta));
+  momentum.SetE(std::sqrt(m_masses[currentType] * m_masses[currentType] + momentum.P2()));
+  pdgId = m_pdgCodes[currentType];
+}
+
+void MultiParticleGun::generateOrigin(Gaudi::LorentzVector& origin) {
+  if (!m_perParticleVertex) {
+    // smearing of the event vertex is done with a vertexsmeartool
+    origin.SetCoordinates(0., 0., 0., 0.);
+    return;
+  }
+  origin.SetCoordinates(m_xmin + m_flatGenerator() * (m_xmax - m_xmin), m_ymin + m_flatGenerator() * (m_ymax - m_ymin),
+                        m_zmin + m_flatGenerator() * (m_zmax - m_zmin), 0.);
+}
+
+/// Generate a single particle
+void MultiParticleGun::generateParticle(Gaudi::LorentzVector& momentum, Gaudi::LorentzVector& origin, int& pdgId) {
+  double eta, phi;
+  generateDirection(eta, phi);
+  generateMomentum(eta, phi, momentum, pdgId);
+  generateOrigin(origin);
+  debug() << " -> " << pdgId << endmsg << "   P   = " << momentum << endmsg;
+}
+
+/// Generate a batch of particles, without isolation
+void MultiParticleGun::generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                         std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds) {
+  // one block of uniform numbers for phi, eta, pt, the particle type and the vertex
+  const std::size_t numPerParticle = m_perParticleVertex ? 7 : 4;
+  m_flatGenerator.shootArray(m_uniforms, numPerParticle * n).ignore();
+  double* phi = m_uniforms.data();
+  double* eta = phi + n;
+  double* pt = eta + n;
+  const double* type = pt + n;
+  ParticleGunBatch::flat(phi, n, m_minPhi, m_deltaPhi);
+  ParticleGunBatch::flat(eta, n, m_minEta, m_deltaEta);
+  if (m_logSpacedPt)
+    ParticleGunBatch::logFlat(pt, n, m_minPt, m_maxPt);
+  else
+    ParticleGunBatch::flat(pt, n, m_minPt, m_maxPt - m_minPt);
+  // masses and the cartesian components
+  m_scratch.resize(5 * n);
+  double* mass = m_scratch.data();
+  ParticleGunBatch::particleTypes(type, n, m_pdgCodes, m_masses, pdgIds, mass);
+  ParticleGunBatch::momentaFromPtEtaPhi(n, pt, eta, phi, mass, mass + n, mass + 2 * n, mass + 3 * n, mass + 4 * n,
+                                        momenta);
+  if (!m_perParticleVertex) {
+    // smearing of the event vertex is done with a vertexsmeartool
+    origins.assign(n, Gaudi::LorentzVector(0., 0., 0., 0.));
+    return;
+  }
+  double* x = m_uniforms.data() + 4 * n;
+  double* y = x + n;
+  double* z = y + n;
+  ParticleGunBatch::flat(x, n, m_xmin, m_xmax - m_xmin);
+  ParticleGunBatch::flat(y, n, m_ymin, m_ymax - m_ymin);
+  ParticleGunBatch::flat(z, n, m_zmin, m_zmax - m_zmin);
+  origins.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    origins[i].SetCoordinates(x[i], y[i], z[i], 0.);
+}
+
+void MultiParticleGun::generateIsolatedParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                                 std::vector<Gaudi::LorentzVector>& origins,
+                                                 std::vector<int>& pdgIds) {
+  const double minDeltaR2 = m_isolationDeltaR * m_isolationDeltaR;
+  momenta.clear();
+  origins.clear();
+  pdgIds.clear();
+  // directions of the particles already in the event
+  std::vector<std::pair<double, double>> directions;
+  directions.reserve(n);
+  Gaudi::LorentzVector momentum;
+  Gaudi::LorentzVector origin;
+  int pdgId;
+  for (std::size_t i = 0; i < n; ++i) {
+    double eta, phi;
+    bool isolated = true;
+    for (unsigned int attempt = 0; attempt < std::max(1u, m_maxIsolationAttempts.value()); ++attempt) {
+      generateDirection(eta, phi);
+      isolated = true;
+      for (const auto& [otherEta, otherPhi] : directions) {
+        const double dEta = eta - otherEta;
+        double dPhi = std::abs(phi - otherPhi);
+        if (dPhi > M_PI)
+          dPhi = 2. * M_PI - dPhi;
+        if (dEta * dEta + dPhi * dPhi < minDeltaR2) {
+          isolated = false;
+          break;
+        }
+      }
+      if (isolated)
+        break;
+    }
+    if (!isolated) {
+      ++m_numNotIsolated;
+      continue;
+    }
+    directions.emplace_back(eta, phi);
+    generateMomentum(eta, phi, momentum, pdgId);
+    generateOrigin(origin);
+    momenta.push_back(momentum);
+    origins.push_back(origin);
+    pdgIds.push_back(pdgId);
+  }
+}
+
+StatusCode MultiParticleGun::getNextEvent(HepMC3::GenEvent& theEvent) {
+  const unsigned int numParticles = numberOfParticles();
+  if (m_isolationDeltaR > 0)
+    generateIsolatedParticles(numParticles, m_momenta, m_origins, m_pdgIds);
+  else
+    generateParticles(numParticles, m_momenta, m_origins, m_pdgIds);
+  const std::size_t numGenerated = m_pdgIds.size();
+  m_particlesPerEvent += numGenerated;
+  /// additional output in rootfile, one entry per particle
+  if (m_writeParticleGunBranches) {
+    m_particleGunBranches.fill(m_momenta.data(), numGenerated, m_minPhi);
+  }
+  if (numGenerated == 0)
+    return StatusCode::SUCCESS;
+
+  theEvent.reserve(numGenerated, m_perParticleVertex ? numGenerated : 1);
+  // need to convert from Gaudi Units  (MeV) to (GeV)
+  const double hepmcMomentumConversionFactor = 0.001;
+  std::shared_ptr<HepMC3::GenVertex> sharedVertex;
+  if (!m_perParticleVertex) {
+    // by calling add_vertex(), the hepmc event is given ownership of the vertex
+    sharedVertex = std::make_shared<HepMC3::GenVertex>(HepMC3::FourVector(0., 0., 0., 0.));
+    theEvent.add_vertex(sharedVertex);
+  }
+  for (std::size_t i = 0; i < numGenerated; ++i) {
+    const auto& momentum = m_momenta[i];
+    // by calling add_particle_out(), the hepmc vertex is given ownership of the particle
+    auto p = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(momentum.Px() * hepmcMomentumConversionFactor,
+                                                                      momentum.Py() * hepmcMomentumConversionFactor,
+                                                                      momentum.Pz() * hepmcMomentumConversionFactor,
+                                                                      momentum.E() * hepmcMomentumConversionFactor),
+                                                   m_pdgIds[i],
+                                                   1); // hepmc status code for final state particle
+    if (m_perParticleVertex) {
+      const auto& origin = m_origins[i];
+      auto v = std::make_shared<HepMC3::GenVertex>(HepMC3::FourVector(origin.X(), origin.Y(), origin.Z(), origin.T()));
+      v->add_particle_out(p);
+      theEvent.add_vertex(v);
+    } else {
+      sharedVertex->add_particle_out(p);
+    }
+  }
+  return StatusCode::SUCCESS;
+}
@@ -0,0 +1,117 @@
+#ifndef GENERATION_MULTIPARTICLEGUN_H
+#define GENERATION_MULTIPARTICLEGUN_H
+
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/PhysicalConstants.h"
+#include "GaudiKernel/RndmGenerators.h"
+#include "GaudiKernel/SystemOfUnits.h"
+#include "Generation/IParticleGunTool.h"
+#include "k4FWCore/DataHandle.h"
+
+#include "ParticleGunBatch.h"
+
+#include <Gaudi/Accumulators.h>
+
+/** @class MultiParticleGun
+ *
+ *  Particle gun producing many particles per event in one pass, for performance scans that need busy events
+ *  without the cost of one HepMC event, vertex smearing and merge per extra particle (as with a pileup gun).
+ *  The number of particles is fixed, Poisson distributed or flat in a range. The particles are drawn flat in pt
+ *  (or log(pt)), eta and phi, like in ConstPtParticleGun, and share one vertex, unless perParticleVertex is set
+ *  and every particle gets its own vertex drawn flat in a box around the origin. With isolationDeltaR, the
+ *  direction of a particle is redrawn until it is separated by at least this distance in eta-phi from the
+ *  particles already in the event.
+ */
+class MultiParticleGun : public AlgTool, virtual public IParticleGunTool {
+public:
+  MultiParticleGun(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~MultiParticleGun();
+  virtual StatusCode initialize();
+  /// Generation of a single particle, without isolation
+  virtual void generateParticle(Gaudi::LorentzVector& momentum, Gaudi::LorentzVector& origin, int& pdgId);
+  /// Generation of a batch of particles, without isolation
+  virtual void generateParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds);
+  virtual void printCounters() { ; };
+  virtual StatusCode getNextEvent(HepMC3::GenEvent&);
+
+private:
+  Gaudi::Property<std::string> m_multiplicity{this, "multiplicity", "Fixed",
+                                              "Distribution of the number of particles: Fixed, Poisson or Range"};
+  Gaudi::Property<double> m_numParticles{this, "numParticles", 1,
+                                         "Number of particles per event (Fixed), or its mean (Poisson)"};
+  Gaudi::Property<unsigned int> m_minNumParticles{this, "numParticlesMin", 1,
+                                                  "Minimal number of particles per event (Range)"};
+  Gaudi::Property<unsigned int> m_maxNumParticles{this, "numParticlesMax", 1,
+                                                  "Maximal number of particles per event (Range)"};
+
+  Gaudi::Property<double> m_minPt{this, "PtMin", 1 * Gaudi::Units::GeV,
+                                  "Lower limit for the flat transverse momenta distribution of generated particles."};
+  Gaudi::Property<double> m_maxPt{this, "PtMax", 100. * Gaudi::Units::GeV,
+                                  "Upper limit for the flat transverse momenta distribution of generated particles"};
+  Gaudi::Property<bool> m_logSpacedPt{this, "logSpacedPt", false,
+                                      "Generate a log-spaced distribution (flat in  log(Pt))"};
+  Gaudi::Property<double> m_minEta{this, "EtaMin", -3.5,
+                                   "Lower limit for the flat pseudorapidity distribution of generated particles."};
+  Gaudi::Property<double> m_maxEta{this, "EtaMax", 3.5,
+                                   "Upper limit for the flat pseudorapidity distribution of generated particles."};
+  Gaudi::Property<double> m_minPhi{this, "PhiMin", 0. * Gaudi::Units::rad,
+                                   "Lower limit for the flat azimuth distribution of generated particles"};
+  Gaudi::Property<double> m_maxPhi{this, "PhiMax", Gaudi::Units::twopi* Gaudi::Units::rad,
+                                   "Upper limit for the azimuth distribution of generated particles"};
+  Gaudi::Property<std::vector<int>> m_pdgCodes{this, "PdgCodes", {-211}, "List of PDG codes to produce."};
+
+  Gaudi::Property<double> m_isolationDeltaR{
+      this, "isolationDeltaR", 0., "Minimal eta-phi distance between the particles of an event, 0 to switch off"};
+  Gaudi::Property<unsigned int> m_maxIsolationAttempts{
+      this, "maxIsolationAttempts", 100, "Directions drawn for a particle before it is dropped as not isolated"};
+
+  Gaudi::Property<bool> m_perParticleVertex{this, "perParticleVertex", false,
+                                            "Give every particle its own vertex, drawn flat in the vertex box"};
+  Gaudi::Property<double> m_xmin{this, "xVertexMin", 0.0 * Gaudi::Units::mm, "Min value for x coordinate"};
+  Gaudi::Property<double> m_ymin{this, "yVertexMin", 0.0 * Gaudi::Units::mm, "Min value for y coordinate"};
+  Gaudi::Property<double> m_zmin{this, "zVertexMin", 0.0 * Gaudi::Units::mm, "Min value for z coordinate"};
+  Gaudi::Property<double> m_xmax{this, "xVertexMax", 0.0 * Gaudi::Units::mm, "Max value for x coordinate"};
+  Gaudi::Property<double> m_ymax{this, "yVertexMax", 0.0 * Gaudi::Units::mm, "Max value for y coordinate"};
+  Gaudi::Property<double> m_zmax{this, "zVertexMax", 0.0 * Gaudi::Units::mm, "Max value for z coordinate"};
+
+  Gaudi::Property<bool> m_writeParticleGunBranches{
+      this, "writeParticleGunBranches", false,
+      "Write the generated pt, eta, cos(theta) and phi of every particle to the ParticleGun_* outputs"};
+  /// optional additional output (switched on by  m_writeParticleGunBranches)
+  ParticleGunBatch::Branches m_particleGunBranches;
+
+  /// number of particles of the next event
+  unsigned int numberOfParticles();
+  /// draw a direction flat in eta and phi
+  void generateDirection(double& eta, double& phi);
+  /// draw pt and the particle type, and set the momentum for the given direction
+  void generateMomentum(double eta, double phi, Gaudi::LorentzVector& momentum, int& pdgId);
+  /// draw a vertex in the vertex box, or the origin without perParticleVertex
+  void generateOrigin(Gaudi::LorentzVector& origin);
+  /// draw up to n particles one by one, dropping those that cannot be isolated
+  void generateIsolatedParticles(std::size_t n, std::vector<Gaudi::LorentzVector>& momenta,
+                                 std::vector<Gaudi::LorentzVector>& origins, std::vector<int>& pdgIds);
+
+  /// helper variables
+  double m_deltaEta;
+  double m_deltaPhi;
+  /// Masses of particles to generate (derived from PDG codes)
+  std::vector<double> m_masses;
+  /// Flat random number generator
+  Rndm::Numbers m_flatGenerator;
+  /// Poisson random number generator for the number of particles
+  Rndm::Numbers m_poissonGenerator;
+  /// Uniform random numbers and scratch space of the batch generation, reused between batches
+  std::vector<double> m_uniforms;
+  std::vector<double> m_scratch;
+  /// particles of the current event
+  std::vector<Gaudi::LorentzVector> m_momenta;
+  std::vector<Gaudi::LorentzVector> m_origins;
+  std::vector<int> m_pdgIds;
+
+  Gaudi::Accumulators::StatCounter<double> m_particlesPerEvent{this, "particles per event"};
+  Gaudi::Accumulators::Counter<> m_numNotIsolated{this, "particles dropped as not isolated"};
+};
+
+#endif // GENERATION_MULTIPARTICLEGUN_H
@@ -0,0 +1,156 @@
+#ifndef GENERATION_PARTICLEGUNBATCH_H
+#define GENERATION_PARTICLEGUNBATCH_H
+
+#include "GaudiKernel/SystemOfUnits.h"
+#include "GaudiKernel/Vector4DTypes.h"
+
+#include "k4FWCore/DataHandle.h"
+#include "podio/UserDataCollection.h"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/** Helpers for the batch generation of the particle guns. The random numbers of a batch are drawn in one block and
+ *  turned into kinematics by plain loops over contiguous arrays, which the compiler can vectorize.
+ */
+namespace ParticleGunBatch {
+
+/// Map uniform numbers in [0, 1) in place to flat values in [min, min + delta)
+inline void flat(double* values, std::size_t n, double min, double delta) {
+  for (std::size_t i = 0; i < n; ++i)
+    values[i] = min + values[i] * delta;
+}
+
+/// Map uniform numbers in [0, 1) in place to values flat in log between min and max (both positive)
+inline void logFlat(double* values, std::size_t n, double min, double max) {
+  const double logMin = std::log(min);
+  const double deltaLog = std::log(max) - logMin;
+  for (std::size_t i = 0; i < n; ++i)
+    values[i] = std::exp(logMin + values[i] * deltaLog);
+}
+
+/// Map uniform numbers in [0, 1) in place to entries of a list
+inline void fromList(double* values, std::size_t n, const std::vector<double>& list) {
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t index = values[i] * list.size();
+    values[i] = list[index < list.size() ? index : 0];
+  }
+}
+
+/// Choose particle types from uniform numbers in [0, 1), and fill the pdg ids and masses
+inline void particleTypes(const double* values, std::size_t n, const std::vector<int>& pdgCodes,
+                          const std::vector<double>& masses, std::vector<int>& pdgIds, double* mass) {
+  pdgIds.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t type = values[i] * pdgCodes.size();
+    // protect against funnies
+    if (type >= pdgCodes.size())
+      type = 0;
+    pdgIds[i] = pdgCodes[type];
+    mass[i] = masses[type];
+  }
+}
+
+/// Compute the four-momenta from pt, eta, phi and mass. The arrays px, py, pz, e are scratch space of size n.
+inline void momentaFromPtEtaPhi(std::size_t n, const double* pt, const double* eta, const double* phi,
+                                const double* mass, double* px, double* py, double* pz, double* e,
+                                std::vector<Gaudi::LorentzVector>& momenta) {
+  for (std::size_t i = 0; i < n; ++i) {
+    px[i] = pt[i] * std::cos(phi[i]);
+    py[i] = pt[i] * std::sin(phi[i]);
+    pz[i] = pt[i] * std::sinh(eta[i]);
+    e[i] = std::sqrt(mass[i] * mass[i] + px[i] * px[i] + py[i] * py[i] + pz[i] * pz[i]);
+  }
+  momenta.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    momenta[i].SetPxPyPzE(px[i], py[i], pz[i], e[i]);
+}
+
+/// Compute the four-momenta from momentum, theta, phi and mass. The arrays px, py, pz, e are scratch space of size n.
+inline void momentaFromPThetaPhi(std::size_t n, const double* p, const double* theta, const double* phi,
+                                 const double* mass, double* px, double* py, double* pz, double* e,
+                                 std::vector<Gaudi::LorentzVector>& momenta) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const double pt = p[i] * std::sin(theta[i]);
+    px[i] = pt * std::cos(phi[i]);
+    py[i] = pt * std::sin(phi[i]);
+    pz[i] = p[i] * std::cos(theta[i]);
+    e[i] = std::sqrt(mass[i] * mass[i] + p[i] * p[i]);
+  }
+  momenta.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    momenta[i].SetPxPyPzE(px[i], py[i], pz[i], e[i]);
+}
+
+/** Optional output of the particle guns (writeParticleGunBranches): the generated pt in GeV, eta, cos(theta) and phi,
+ *  one UserDataCollection per quantity (ParticleGun_Pt, ParticleGun_Eta, ParticleGun_costheta, ParticleGun_Phi) with
+ *  one entry per particle.
+ */
+struct Branches {
+  using Handle = k4FWCore::DataHandle<podio::UserDataCollection<float>>;
+  std::unique_ptr<Handle> pt;
+  std::unique_ptr<Handle> eta;
+  std::unique_ptr<Handle> costheta;
+  std::unique_ptr<Handle> phi;
+
+  template <typename Owner>
+  void declare(Owner* owner) {
+    pt = std::make_unique<Handle>("ParticleGun_Pt", Gaudi::DataHandle::Writer, owner);
+    eta = std::make_unique<Handle>("ParticleGun_Eta", Gaudi::DataHandle::Writer, owner);
+    costheta = std::make_unique<Handle>("ParticleGun_costheta", Gaudi::DataHandle::Writer, owner);
+    phi = std::make_unique<Handle>("ParticleGun_Phi", Gaudi::DataHandle::Writer, owner);
+  }
+
+  /// Put the collections of the event, filled in one pass over the momenta, with phi in [phiMin, phiMin + 2 pi)
+  void fill(const Gaudi::LorentzVector* momenta, std::size_t n, double phiMin) {
+    auto& ptValues = pt->createAndPut()->vec();
+    auto& etaValues = eta->createAndPut()->vec();
+    auto& costhetaValues = costheta->createAndPut()->vec();
+    auto& phiValues = phi->createAndPut()->vec();
+    for (auto* values : {&ptValues, &etaValues, &costhetaValues, &phiValues})
+      values->reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& momentum = momenta[i];
+      double momentumPhi = momentum.Phi();
+      while (momentumPhi < phiMin)
+        momentumPhi += 2 * M_PI;
+      while (momentumPhi >= phiMin + 2 * M_PI)
+        momentumPhi -= 2 * M_PI;
+      ptValues.push_back(momentum.Pt() / Gaudi::Units::GeV);
+      etaValues.push_back(momentum.Eta());
+      costhetaValues.push_back(momentum.Pz() / momentum.P());
+      phiValues.push_back(momentumPhi);
+    }
+  }
+};
+
+/** Particles generated ahead in batches, served one per event by the single-particle guns, so that their per-event
+ *  cost is that of the batch generation.
+ */
+struct Buffer {
+  std::vector<Gaudi::LorentzVector> momenta;
+  std::vector<Gaudi::LorentzVector> origins;
+  std::vector<int> pdgIds;
+  std::size_t next{0};
+
+  bool empty() const { return next >= pdgIds.size(); }
+  void clear() {
+    momenta.clear();
+    origins.clear();
+    pdgIds.clear();
+    next = 0;
+  }
+  /// Take the next particle; the buffer must not be empty
+  void pop(Gaudi::LorentzVector& momentum, Gaudi::LorentzVector& origin, int& pdgId) {
+    momentum = momenta[next];
+    origin = origins[next];
+    pdgId = pdgIds[next];
+    ++next;
+  }
+};
+
+} // namespace ParticleGunBatch
+
+#endif // GENERATION_PARTICLEGUNBATCH_H
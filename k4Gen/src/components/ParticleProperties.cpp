@@ -0,0 +1,119 @@
+
+#include "ParticleProperties.h"
+
+#include "GaudiKernel/System.h"
+#include "HepPDT/ParticleID.hh"
+#include "Pythia8/Pythia.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace {
+struct Entry {
+  int pdgId;
+  ParticleProperties::Properties properties;
+};
+
+/// PDG values as in the Pythia8 database, sorted by PDG code: mass and width in GeV, c*tau in mm, charge in e
+constexpr std::array<Entry, 44> compiledInTable{{
+    {11, {0.000510999, 0., 0., -1.}},
+    {12, {0., 0., 0., 0.}},
+    {13, {0.105658, 0., 658654., -1.}},
+    {14, {0., 0., 0., 0.}},
+    {15, {1.77686, 2.265e-12, 0.08703, -1.}},
+    {16, {0., 0., 0., 0.}},
+    {21, {0., 0., 0., 0.}},
+    {22, {0., 0., 0., 0.}},
+    {23, {91.1876, 2.4952, 0., 0.}},
+    {24, {80.385, 2.085, 0., 1.}},
+    {25, {125., 0.00403, 0., 0.}},
+    {111, {0.13498, 0., 2.5506e-05, 0.}},
+    {113, {0.77549, 0.1491, 0., 0.}},
+    {130, {0.497614, 0., 15340., 0.}},
+    {211, {0.13957, 0., 7804.5, 1.}},
+    {213, {0.77549, 0.1491, 0., 1.}},
+    {221, {0.547862, 1.31e-06, 0., 0.}},
+    {223, {0.78265, 0.00849, 0., 0.}},
+    {310, {0.497614, 0., 26.844, 0.}},
+    {313, {0.89594, 0.0487, 0., 0.}},
+    {321, {0.493677, 0., 3712., 1.}},
+    {323, {0.89166, 0.0508, 0., 1.}},
+    {331, {0.95778, 0.000198, 0., 0.}},
+    {333, {1.01946, 0.00426, 0., 0.}},
+    {411, {1.86962, 0., 0.3118, 1.}},
+    {421, {1.86486, 0., 0.1229, 0.}},
+    {431, {1.96849, 0., 0.1499, 1.}},
+    {443, {3.09692, 9.29e-05, 0., 0.}},
+    {511, {5.27958, 0., 0.4557, 0.}},
+    {521, {5.27926, 0., 0.4911, 1.}},
+    {531, {5.36677, 0., 0.4527, 0.}},
+    {553, {9.4603, 5.402e-05, 0., 0.}},
+    {2112, {0.939565, 0., 2.6391e+14, 0.}},
+    {2212, {0.938272, 0., 0., 1.}},
+    {3112, {1.19745, 0., 44.34, -1.}},
+    {3122, {1.11568, 0., 78.89, 0.}},
+    {3212, {1.19264, 0., 2.22e-08, 0.}},
+    {3222, {1.18937, 0., 24.04, 1.}},
+    {3312, {1.32171, 0., 49.1, -1.}},
+    {3322, {1.31486, 0., 87.1, 0.}},
+    {3334, {1.67245, 0., 24.61, -1.}},
+    {4122, {2.28646, 0., 0.0599, 1.}},
+    {5122, {5.6194, 0., 0.4395, 0.}},
+    {1000010020, {1.875613, 0., 0., 1.}},
+}};
+} // namespace
+
+ParticleProperties::ParticleProperties() {}
+
+ParticleProperties::~ParticleProperties() {}
+
+const ParticleProperties& ParticleProperties::instance() {
+  static const ParticleProperties table;
+  return table;
+}
+
+const ParticleProperties::Properties* ParticleProperties::compiledIn(int pdgId) {
+  auto it = std::lower_bound(compiledInTable.begin(), compiledInTable.end(), pdgId,
+                             [](const Entry& entry, int id) { return entry.pdgId < id; });
+  if (it == compiledInTable.end() || it->pdgId != pdgId)
+    return nullptr;
+  return &it->properties;
+}
+
+std::vector<int> ParticleProperties::compiledInPdgIds() {
+  std::vector<int> pdgIds;
+  for (const auto& entry : compiledInTable)
+    pdgIds.push_back(entry.pdgId);
+  return pdgIds;
+}
+
+ParticleProperties::Properties ParticleProperties::properties(int pdgId) const {
+  const int particleId = std::abs(pdgId);
+  const double sign = pdgId < 0 ? -1. : 1.;
+  if (const Properties* entry = compiledIn(particleId))
+    return {entry->mass, entry->width, entry->ctau, sign * entry->charge};
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto cached = m_cache.find(particleId);
+  if (cached == m_cache.end()) {
+    if (!m_pythia) {
+      // same database as PythiaInterface and DecayParticleGun
+      std::string xmlpath = "../share/Pythia8/xmldoc";
+      if (System::getEnv("PYTHIA8_XML") != "UNKNOWN")
+        xmlpath = System::getEnv("PYTHIA8_XML");
+      m_pythia = std::make_unique<Pythia8::Pythia>(xmlpath, false);
+    }
+    auto& data = m_pythia->particleData;
+    Properties entry{data.m0(particleId), data.mWidth(particleId), data.tau0(particleId), charge(particleId)};
+    cached = m_cache.emplace(particleId, entry).first;
+  }
+  const Properties& entry = cached->second;
+  return {entry.mass, entry.width, entry.ctau, sign * entry.charge};
+}
+
+double ParticleProperties::charge(int pdgId) const {
+  if (const Properties* entry = compiledIn(std::abs(pdgId)))
+    return pdgId < 0 ? -entry->charge : entry->charge;
+  return HepPDT::ParticleID(pdgId).charge();
+}
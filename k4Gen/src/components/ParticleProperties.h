@@ -0,0 +1,64 @@
+#ifndef GENERATION_PARTICLEPROPERTIES_H
+#define GENERATION_PARTICLEPROPERTIES_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Pythia8 {
+class Pythia;
+}
+
+/** @class ParticleProperties
+ *
+ *  Process-wide table of the particle properties used by the k4Gen components: mass, width, proper lifetime and
+ *  charge. The common leptons, bosons and hadrons are compiled in, so that looking them up needs no database. For
+ *  other PDG codes the Pythia8 particle database is read once per process, on first use, and the looked up entries
+ *  are cached. Charges of codes that are not compiled in are computed from the PDG code with HepPDT.
+ */
+class ParticleProperties {
+public:
+  struct Properties {
+    /// mass in GeV
+    double mass;
+    /// width in GeV
+    double width;
+    /// proper lifetime c*tau in mm
+    double ctau;
+    /// charge in units of e
+    double charge;
+  };
+
+  /// The table shared by all components
+  static const ParticleProperties& instance();
+
+  /// Properties of a particle; those of an antiparticle have the opposite charge
+  Properties properties(int pdgId) const;
+  /// Mass in GeV
+  double mass(int pdgId) const { return properties(pdgId).mass; }
+  /// Width in GeV
+  double width(int pdgId) const { return properties(pdgId).width; }
+  /// Proper lifetime c*tau in mm
+  double ctau(int pdgId) const { return properties(pdgId).ctau; }
+  /// Charge in units of e, never needs the Pythia8 database
+  double charge(int pdgId) const;
+  /// Particle codes that are compiled in, without the antiparticles
+  static std::vector<int> compiledInPdgIds();
+
+  ParticleProperties(const ParticleProperties&) = delete;
+  ParticleProperties& operator=(const ParticleProperties&) = delete;
+
+private:
+  ParticleProperties();
+  ~ParticleProperties();
+
+  /// compiled-in properties of a particle (not antiparticle) code, nullptr if it is not in the table
+  static const Properties* compiledIn(int pdgId);
+
+  /// entries looked up in the Pythia8 database, by particle (not antiparticle) code
+  mutable std::mutex m_mutex;
+  mutable std::unordered_map<int, Properties> m_cache;
+  mutable std::unique_ptr<Pythia8::Pythia> m_pythia;
+};
+#endif
@@ -0,0 +1,61 @@
+#include "PileUpToEDMConverter.h"
+#include "ParticleProperties.h"
+// EDM4hep
+#include "edm4hep/MCParticleCollection.h"
+
+
+DECLARE_COMPONENT(PileUpToEDMConverter)
+
+namespace {
+/// speed of light in mm/ns, to convert the HepMC times in mm/c
+constexpr double c_light = 299.792458;
+} // namespace
+
+PileUpToEDMConverter::PileUpToEDMConverter(const std::string& name, ISvcLocator* svcLoc)
+    : Gaudi::Algorithm(name, svcLoc) {
+  declareProperty("pileUpParticles", m_pileUpHandle, "Compact pileup particles (input)");
+  declareProperty("GenParticles", m_genphandle, "Generated pileup particles collection (output)");
+  declareProperty("PileUpInteractions", m_interactionHandle,
+                  "Pileup interaction index of every generated particle (output)");
+}
+
+StatusCode PileUpToEDMConverter::initialize() {
+  m_timeStages = m_monitorStages || !m_stageSummaryFile.empty();
+  return Gaudi::Algorithm::initialize();
+}
+
+StatusCode PileUpToEDMConverter::execute(const EventContext&) const {
+  StageTimer timer(m_time, m_timeStages);
+  const PileUpParticles* pileUp = m_pileUpHandle.get();
+  edm4hep::MCParticleCollection* particles = m_genphandle.createAndPut();
+  convertParticles(*pileUp, *particles);
+  auto* interactions = m_interactionHandle.createAndPut();
+  interactions->vec().assign(pileUp->interaction.begin(), pileUp->interaction.end());
+  m_numParticles += particles->size();
+  return StatusCode::SUCCESS;
+}
+
+void PileUpToEDMConverter::convertParticles(const PileUpParticles& pileUp,
+                                            edm4hep::MCParticleCollection& particles) const {
+  const auto& particleProperties = ParticleProperties::instance();
+  for (std::size_t i = 0; i < pileUp.size(); ++i) {
+    auto particle = particles.create();
+    particle.setPDG(pileUp.pdg[i]);
+    particle.setGeneratorStatus(pileUp.status[i]);
+    particle.setCharge(static_cast<float>(particleProperties.charge(pileUp.pdg[i])));
+    particle.setMomentum({pileUp.px[i], pileUp.py[i], pileUp.pz[i]});
+    // the generated mass, as in HepMCToEDMConverter; rebuilding it from the float four-momentum cancels badly
+    particle.setMass(pileUp.m[i]);
+    particle.setVertex({pileUp.vx[i], pileUp.vy[i], pileUp.vz[i]});
+    particle.setTime(pileUp.t[i] / c_light);
+  }
+}
+
+StatusCode PileUpToEDMConverter::finalize() {
+  if (!m_stageSummaryFile.empty()) {
+    StageCounters counters{{"time conversion [ms]", &m_time}, {"particles", &m_numParticles}};
+    if (!writeStageSummary(m_stageSummaryFile, name(), m_time, counters))
+      warning() << "Could not write the stage summary to " << m_stageSummaryFile.value() << endmsg;
+  }
+  return Gaudi::Algorithm::finalize();
+}
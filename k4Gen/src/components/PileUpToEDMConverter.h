@@ -0,0 +1,58 @@
+#ifndef GENERATION_PILEUPTOEDMCONVERTER_H
+#define GENERATION_PILEUPTOEDMCONVERTER_H
+
+// Gaudi
+#include "Gaudi/Algorithm.h"
+// k4FWCore
+#include "k4FWCore/DataHandle.h"
+
+#include "Generation/PileUpParticles.h"
+#include "StageMonitor.h"
+
+#include "podio/UserDataCollection.h"
+
+#include <cstdint>
+
+namespace edm4hep {
+class MCParticleCollection;
+} // namespace edm4hep
+
+/** @class PileUpToEDMConverter
+ *
+ *  Converts the compact pileup particles written by GenAlg with compactPileUp directly into an EDM4hep collection,
+ *  without going through HepMC. The pileup interaction of every particle is written to a parallel collection.
+ */
+class PileUpToEDMConverter : public Gaudi::Algorithm {
+
+public:
+  /// Constructor.
+  PileUpToEDMConverter(const std::string& name, ISvcLocator* svcLoc);
+  /// Initialize.
+  virtual StatusCode initialize();
+  /// Execute.
+  virtual StatusCode execute(const EventContext&) const;
+  /// Finalize.
+  virtual StatusCode finalize();
+  /// Convert the compact pileup particles into the collection
+  void convertParticles(const PileUpParticles& pileUp, edm4hep::MCParticleCollection& particles) const;
+
+private:
+  /// Handle for the compact pileup particles to be read
+  mutable k4FWCore::DataHandle<PileUpParticles> m_pileUpHandle{"pileUpParticles", Gaudi::DataHandle::Reader, this};
+  /// Handle for the genparticles to be written
+  mutable k4FWCore::DataHandle<edm4hep::MCParticleCollection> m_genphandle{"PileUpGenParticles",
+                                                                            Gaudi::DataHandle::Writer, this};
+  /// Handle for the pileup interaction index of every genparticle
+  mutable k4FWCore::DataHandle<podio::UserDataCollection<uint32_t>> m_interactionHandle{
+      "PileUpInteractions", Gaudi::DataHandle::Writer, this};
+
+  /// Switch for the conversion timer
+  Gaudi::Property<bool> m_monitorStages{this, "monitorStages", false, "Time the conversion of every event"};
+  /// JSON summary of the timer and counters written at finalize, enables the timer
+  Gaudi::Property<std::string> m_stageSummaryFile{this, "stageSummaryFile", "",
+                                                  "File for a JSON summary of the timer and counters"};
+  bool m_timeStages{false};
+  mutable Gaudi::Accumulators::StatCounter<double> m_time{this, "time conversion [ms]"};
+  mutable Gaudi::Accumulators::StatCounter<double> m_numParticles{this, "particles"};
+};
+#endif
@@ -0,0 +1,120 @@
+#include "ProfilePileUp.h"
+#include "GaudiKernel/IRndmGenSvc.h"
+
+#include <cmath>
+
+DECLARE_COMPONENT(ProfilePileUp)
+
+ProfilePileUp::ProfilePileUp(const std::string& type, const std::string& name, const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<IPileUpTool>(this);
+}
+
+ProfilePileUp::~ProfilePileUp() { ; }
+
+StatusCode ProfilePileUp::initialize() {
+  StatusCode sc = AlgTool::initialize();
+  if (sc.isFailure())
+    return sc;
+  m_histogram = m_muValues.size() == m_weights.size() + 1;
+  if (!m_histogram && m_muValues.size() != m_weights.size()) {
+    error() << "muValues needs as many entries as weights, or one more for bin edges" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (std::size_t i = 0; i < m_muValues.size(); ++i) {
+    if (m_muValues[i] < 0 || (m_histogram && i > 0 && m_muValues[i] < m_muValues[i - 1])) {
+      error() << "Values of mu cannot be negative, and bin edges have to be increasing" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (!m_profile.build(m_weights)) {
+    error() << "Weights of the mu profile have to be non-negative with a positive sum" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_meanMu = 0.;
+  for (std::size_t i = 0; i < m_profile.size(); ++i) {
+    const double mu = m_histogram ? 0.5 * (m_muValues[i] + m_muValues[i + 1]) : m_muValues[i];
+    m_meanMu += m_profile.probability(i) * mu;
+  }
+  m_binCounts.assign(m_profile.size(), 0);
+
+  auto randSvc = service<IRndmGenSvc>("RndmGenSvc", true);
+  sc = m_flatDist.initialize(randSvc, Rndm::Flat(0., 1.));
+  if (!sc.isSuccess()) {
+    error() << "Could not initialize flat random number generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Mean mu of the profile: " << m_meanMu << endmsg;
+  return sc;
+}
+
+unsigned int ProfilePileUp::poisson(double mu) {
+  if (mu <= 0.)
+    return 0;
+  if (mu < 10.) {
+    // multiplication of uniform numbers, O(mu)
+    const double limit = std::exp(-mu);
+    unsigned int k = 0;
+    double p = m_flatDist();
+    while (p > limit) {
+      ++k;
+      p *= m_flatDist();
+    }
+    return k;
+  }
+  // transformed rejection with squeeze (PTRS, W. Hoermann 1993), O(1) for large mu
+  const double smu = std::sqrt(mu);
+  const double logMu = std::log(mu);
+  const double b = 0.931 + 2.53 * smu;
+  const double a = -0.059 + 0.02483 * b;
+  const double invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+  const double vr = 0.9277 - 3.6224 / (b - 2.);
+  while (true) {
+    const double u = m_flatDist() - 0.5;
+    const double v = m_flatDist();
+    const double us = 0.5 - std::abs(u);
+    const double k = std::floor((2. * a / us + b) * u + mu + 0.43);
+    if (us >= 0.07 && v <= vr)
+      return k;
+    if (k < 0. || (us < 0.013 && v > us))
+      continue;
+    if (std::log(v) + std::log(invAlpha) - std::log(a / (us * us) + b) <= -mu + k * logMu - std::lgamma(k + 1.))
+      return k;
+  }
+}
+
+unsigned int ProfilePileUp::numberOfPileUp() {
+  const double u1 = m_flatDist();
+  const double u2 = m_flatDist();
+  const std::size_t bin = m_profile.sample(u1, u2);
+  ++m_binCounts[bin];
+  m_currentMu = m_histogram ? m_muValues[bin] + m_flatDist() * (m_muValues[bin + 1] - m_muValues[bin])
+                            : m_muValues[bin];
+  m_currentNumPileUpEvents = poisson(m_currentMu);
+  m_mu += m_currentMu;
+  m_numPileUp += m_currentNumPileUpEvents;
+  return m_currentNumPileUpEvents;
+}
+
+double ProfilePileUp::getMeanPileUp() { return m_meanMu; }
+
+void ProfilePileUp::printPileUpCounters() {
+  info() << "Current mu: " << m_currentMu << ", number of pileup events:  " << m_currentNumPileUpEvents << endmsg;
+}
+
+StatusCode ProfilePileUp::finalize() {
+  const unsigned long total = m_mu.nEntries();
+  if (total > 0) {
+    info() << "Realized pileup over " << total << " events: mu " << m_mu.mean() << " +- " << m_mu.standard_deviation()
+           << " (profile " << m_meanMu << "), pileup events " << m_numPileUp.mean() << " +- "
+           << m_numPileUp.standard_deviation() << endmsg;
+    info() << "Fraction of events per mu " << (m_histogram ? "bin" : "value") << " (realized / profile):" << endmsg;
+    for (std::size_t i = 0; i < m_binCounts.size(); ++i) {
+      info() << "  mu " << m_muValues[i];
+      if (m_histogram)
+        info() << " - " << m_muValues[i + 1];
+      info() << ": " << double(m_binCounts[i]) / total << " / " << m_profile.probability(i) << endmsg;
+    }
+  }
+  return AlgTool::finalize();
+}
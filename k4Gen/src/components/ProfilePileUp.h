@@ -0,0 +1,61 @@
+#ifndef GENERATION_PROFILEPILEUP_H
+#define GENERATION_PROFILEPILEUP_H
+
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/RndmGenerators.h"
+#include "Generation/IPileUpTool.h"
+
+#include "AliasTable.h"
+
+#include <Gaudi/Accumulators.h>
+
+/** @class ProfilePileUp
+ *
+ *  Tool to generate number of pile-up events to be mixed with signal event.
+ *  Concrete implementation of a IPileUpTool, drawing for every event the mean
+ *  number of interactions mu from a profile, e.g. the luminosity of a fill
+ *  or the bunch intensities, and then the number of pileup events from a
+ *  Poisson distribution with this mean. A whole fill can thus be covered by
+ *  one production instead of one production per mu.
+ *
+ *  The profile is given by the values of mu and their weights. With one more
+ *  value than weights, the values are the bin edges of a histogram and mu is
+ *  flat within the bin; otherwise every weight belongs to a single value.
+ *  The bin is drawn with an alias table, in constant time.
+ */
+class ProfilePileUp : public AlgTool, virtual public IPileUpTool {
+public:
+  ProfilePileUp(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~ProfilePileUp();
+  virtual StatusCode initialize();
+  virtual StatusCode finalize();
+  virtual unsigned int numberOfPileUp();
+  virtual double getMeanPileUp();
+  virtual void printPileUpCounters();
+
+private:
+  /// values of mu, or bin edges of the mu histogram
+  Gaudi::Property<std::vector<double>> m_muValues{
+      this, "muValues", {}, "Values of mu, or bin edges of the mu histogram if there is one more than weights"};
+  /// relative weights of the values or bins, e.g. integrated luminosity or number of bunch crossings
+  Gaudi::Property<std::vector<double>> m_weights{this, "weights", {}, "Relative weights of the mu values or bins"};
+
+  /// Poisson distributed number with mean mu
+  unsigned int poisson(double mu);
+
+  bool m_histogram{false};
+  AliasTable m_profile;
+  double m_meanMu{0.};
+  /// flat random number generator in [0, 1)
+  Rndm::Numbers m_flatDist;
+  /// holds last realization of mu and of the number of pileup events
+  double m_currentMu{0.};
+  unsigned int m_currentNumPileUpEvents{0};
+
+  /// realized distribution
+  std::vector<unsigned long> m_binCounts;
+  Gaudi::Accumulators::StatCounter<double> m_mu{this, "mu"};
+  Gaudi::Accumulators::StatCounter<double> m_numPileUp{this, "pileup events"};
+};
+
+#endif // GENERATION_PROFILEPILEUP_H
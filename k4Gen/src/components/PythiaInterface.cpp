@@ -4,18 +4,73 @@
 #include "GaudiKernel/Incident.h"
 #include "GaudiKernel/System.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <fstream>
+#include <sstream>
+
 #include "Pythia8/Pythia.h"
 // Include UserHooks for Jet Matching.
 #include "Pythia8Plugins/CombineMatchingInput.h"
 #include "Pythia8Plugins/JetMatching.h"
 // Include UserHooks for randomly choosing between integrated and
 // non-integrated treatment for unitarised merging.
+#include "EvtGenDecayCache.h"
+#include "EvtGenSetup.h"
 #include "HepMC3/GenEvent.h"
+#include "KtClustering.h"
+#include "LHEPrefetcher.h"
 #include "Pythia8Plugins/EvtGen.h"
 #include "Pythia8Plugins/aMCatNLOHooks.h"
 
 DECLARE_COMPONENT(PythiaInterface)
 
+namespace {
+/// 64-bit FNV-1a hash as zero-padded hex string, stable across builds and platforms
+std::string fnv1aHash(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return key.str();
+}
+
+/// Content of a file as string, empty if it cannot be read
+std::string readWholeFile(const std::string& filename) {
+  std::ifstream file(filename);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/// Whether a Pythia setting line sets the random seed (Random:seed or Random:setSeed), which does not change the
+/// configured state and is left out of the cache key
+bool isSeedSetting(const std::string& line) {
+  std::string key;
+  std::istringstream(line.substr(0, line.find('='))) >> key;
+  std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+  return key == "random:seed" || key == "random:setseed";
+}
+
+/// Agreement of two clustering results up to rounding, used to validate the jet backends against each other
+bool sameWithinTolerance(const std::vector<double>& a, const std::vector<double>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::abs(a[i] - b[i]) > 1e-6 * std::max({1., std::abs(a[i]), std::abs(b[i])}))
+      return false;
+  }
+  return true;
+}
+} // namespace
+
 PythiaInterface::PythiaInterface(const std::string& type, const std::string& name, const IInterface* parent)
     : AlgTool(type, name, parent), m_pythiaSignal(nullptr), m_maxAborts(0), m_doMePsMatching(0), m_doMePsMerging(0),
       m_matching(nullptr), m_setting(nullptr) {}
@@ -37,27 +92,61 @@ StatusCode PythiaInterface::initialize() {
   if (System::getEnv("PYTHIA8_XML") != "UNKNOWN")
     xmlpath = System::getEnv("PYTHIA8_XML");
 
-  // Initialize Pythia8
-  m_pythiaSignal = std::make_unique<Pythia8::Pythia>(xmlpath);
+  // Restore settings and particle data of a previous job with the same configuration
+  std::string initCacheKey;
+  if (!m_initCacheDir.empty()) {
+    initCacheKey = computeInitCacheKey(xmlpath);
+    loadInitCache(initCacheKey);
+  }
 
-  // Add settings for resonance decay filter
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:filter", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:exclusive", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:eMuAsEquivalent", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:eMuTauAsEquivalent", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:allNuAsEquivalent", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:udscAsEquivalent", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:udscbAsEquivalent", false);
-  m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:wzAsEquivalent", false);
-  m_pythiaSignal->settings.addMVec("ResonanceDecayFilter:mothers", std::vector<int>(), false, false, 0, 0);
-  m_pythiaSignal->settings.addMVec("ResonanceDecayFilter:daughters", std::vector<int>(), false, false, 0, 0);
+  if (!m_pythiaSignal) {
+    // Initialize Pythia8
+    m_pythiaSignal = std::make_unique<Pythia8::Pythia>(xmlpath);
+
+    // Add settings for resonance decay filter
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:filter", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:exclusive", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:eMuAsEquivalent", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:eMuTauAsEquivalent", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:allNuAsEquivalent", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:udscAsEquivalent", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:udscbAsEquivalent", false);
+    m_pythiaSignal->settings.addFlag("ResonanceDecayFilter:wzAsEquivalent", false);
+    m_pythiaSignal->settings.addMVec("ResonanceDecayFilter:mothers", std::vector<int>(), false, false, 0, 0);
+    m_pythiaSignal->settings.addMVec("ResonanceDecayFilter:daughters", std::vector<int>(), false, false, 0, 0);
+
+    // Add settings for kinematic preselection
+    m_pythiaSignal->settings.addFlag("KinematicPreselection:filter", false);
+    m_pythiaSignal->settings.addMVec("KinematicPreselection:pdgIds", std::vector<int>(), false, false, 0, 0);
+    m_pythiaSignal->settings.addParm("KinematicPreselection:ptMin", 0., true, false, 0., 0.);
+    m_pythiaSignal->settings.addParm("KinematicPreselection:absEtaMax", 1e10, true, false, 0., 0.);
+    m_pythiaSignal->settings.addParm("KinematicPreselection:mHatMin", 0., true, false, 0., 0.);
+    m_pythiaSignal->settings.addMode("KinematicPreselection:nMin", 1, true, false, 0, 0);
+    m_pythiaSignal->settings.addMode("KinematicPreselection:nShowerSteps", 0, true, false, 0, 0);
+
+    // Read Pythia configuration file
+    m_pythiaSignal->readFile(m_pythiacard.value().c_str());
+
+    // Apply any extra Pythia8 settings
+    for (auto pythiacommand : m_pythia_extrasettings) {
+      m_pythiaSignal->settings.readString(pythiacommand);
+    }
 
-  // Read Pythia configuration file
-  m_pythiaSignal->readFile(m_pythiacard.value().c_str());
+    if (!initCacheKey.empty()) {
+      saveInitCache(initCacheKey);
+    }
+  } else {
+    applySeedSettings();
+  }
 
-  // Apply any extra Pythia8 settings
-  for (auto pythiacommand : m_pythia_extrasettings) {
-    m_pythiaSignal->settings.readString(pythiacommand);
+  // Feed Pythia from the LHE files through the prefetcher instead of reading Beams:LHEF inside next()
+  if (!m_lheFiles.empty()) {
+    m_lhePrefetcher =
+        std::make_shared<LHEPrefetcher>(m_lheFiles.value(), m_lheFirstEvent, m_lheMaxEvents, m_lhePrefetchSize);
+    m_pythiaSignal->settings.mode("Beams:frameType", 5);
+    m_pythiaSignal->setLHAupPtr(m_lhePrefetcher);
+    info() << "Reading " << m_lheFiles.size() << " LHE file(s) on a background thread, starting at event "
+           << m_lheFirstEvent.value() << endmsg;
   }
 
   // Initialize variables from configuration file
@@ -106,7 +195,18 @@ StatusCode PythiaInterface::initialize() {
   }
 
   // Jet clustering needed for matching
-  m_slowJet = std::make_unique<Pythia8::SlowJet>(1, 0.4, 0, 4.4, 2, 2, nullptr, false);
+  if (m_computeMePsMatchingVars && (m_doMePsMatching || m_doMePsMerging)) {
+    if (m_jetBackend != "SlowJet" && m_jetBackend != "KtClustering") {
+      error() << "Unknown jetBackend " << m_jetBackend.value() << ", use SlowJet or KtClustering" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_jetBackend == "SlowJet" || m_validateJetBackend)
+      m_slowJet = std::make_unique<Pythia8::SlowJet>(1, 0.4, 0, 4.4, 2, 2, nullptr, false);
+    if (m_jetBackend == "KtClustering" || m_validateJetBackend)
+      m_ktClustering = std::make_unique<KtClustering>(0.4, 4.4);
+    m_jetInput.init("jet input", &(m_pythiaSignal->particleData));
+    m_doShowerKt = m_pythiaSignal->settings.flag("JetMatching:doShowerKt");
+  }
 
   // End ME/PS Matching specific code
 
@@ -139,28 +239,22 @@ StatusCode PythiaInterface::initialize() {
     m_resonanceDecayFilterHook = new ResonanceDecayFilterHook();
     m_pythiaSignal->addUserHooksPtr((Pythia8::UserHooksPtr)m_resonanceDecayFilterHook);
   }
+  bool kinematicPreselection = m_pythiaSignal->settings.flag("KinematicPreselection:filter");
+  if (kinematicPreselection) {
+    m_kinematicPreselectionHook = new KinematicPreselectionHook();
+    m_pythiaSignal->addUserHooksPtr((Pythia8::UserHooksPtr)m_kinematicPreselectionHook);
+  }
 
   // Set up evtGen
   if (m_doEvtGenDecays) {
-    m_evtgen = new Pythia8::EvtGenDecays(
-        m_pythiaSignal.get(),             // the pythia instance
-        m_EvtGenDecayFile.value(),        // the file name of the evtgen decay file
-        m_EvtGenParticleDataFile.value(), // the file name of the evtgen data file
-        nullptr, // the optional EvtExternalGenList pointer (must be be provided if the next argument is provided to
-                 // avoid double initializations)
-        nullptr, // the EvtAbsRadCorr pointer to pass to EvtGen
-        1,       // the mixing type to pass to EvtGen
-        false,   // a flag to use XML files to pass to EvtGen
-        true,    // a flag to limit decays based on the Pythia criteria (based on the particle decay vertex)
-        true,    // a flag to use external models with EvtGen
-        false);  // a flag if an FSR model should be passed to EvtGen (pay attention to this, default is true)
-    if (!m_UserDecayFile.empty()) {
-      m_evtgen->readDecayFile(m_UserDecayFile);
-    }
-    // Possibility to force Pythia8 to do decays
-    for (auto _pdgid : m_evtGenExcludes) {
-      m_evtgen->exclude(_pdgid);
+    // Use the merged decay table from the cache if possible, it already contains the user decays
+    std::string evtGenDecayFile = m_initCacheDir.empty() ? "" : prepareEvtGenDecayCache();
+    const bool useDecayCache = !evtGenDecayFile.empty();
+    if (!useDecayCache) {
+      evtGenDecayFile = m_EvtGenDecayFile.value();
     }
+    m_evtgen = EvtGenSetup::makeEvtGenDecays(m_pythiaSignal.get(), evtGenDecayFile, m_EvtGenParticleDataFile,
+                                             useDecayCache ? "" : m_UserDecayFile.value(), m_evtGenExcludes);
   }
 
   m_pythiaSignal->init();
@@ -168,11 +262,141 @@ StatusCode PythiaInterface::initialize() {
   return StatusCode::SUCCESS;
 }
 
+std::string PythiaInterface::computeInitCacheKey(const std::string& xmlpath) const {
+  // collect everything that determines the configured state before init(), except for the seeds so that jobs that
+  // only differ in their seed share the cache
+  std::ostringstream config;
+  config << PYTHIA_VERSION_INTEGER << '\n' << xmlpath << '\n';
+  std::istringstream card(readWholeFile(m_pythiacard.value()));
+  std::string line;
+  while (std::getline(card, line)) {
+    if (!isSeedSetting(line))
+      config << line << '\n';
+  }
+  config << '\n';
+  for (const auto& pythiacommand : m_pythia_extrasettings) {
+    if (!isSeedSetting(pythiacommand))
+      config << pythiacommand << '\n';
+  }
+  return fnv1aHash(config.str());
+}
+
+void PythiaInterface::applySeedSettings() {
+  // the cached settings hold the seeds of the job that wrote them
+  m_pythiaSignal->settings.resetFlag("Random:setSeed");
+  m_pythiaSignal->settings.resetMode("Random:seed");
+  std::istringstream card(readWholeFile(m_pythiacard.value()));
+  std::string line;
+  while (std::getline(card, line)) {
+    if (isSeedSetting(line))
+      m_pythiaSignal->settings.readString(line);
+  }
+  for (const auto& pythiacommand : m_pythia_extrasettings) {
+    if (isSeedSetting(pythiacommand))
+      m_pythiaSignal->settings.readString(pythiacommand);
+  }
+}
+
+void PythiaInterface::loadInitCache(const std::string& key) {
+  const std::string prefix = m_initCacheDir.value() + "/pythia_" + key;
+  std::ifstream settingsStream(prefix + ".settings.xml");
+  std::ifstream particleDataStream(prefix + ".particledata.xml");
+  if (!settingsStream.good() || !particleDataStream.good()) {
+    info() << "No cached Pythia8 initialization state for key " << key << ", doing full initialization" << endmsg;
+    return;
+  }
+
+  m_pythiaSignal = std::make_unique<Pythia8::Pythia>(settingsStream, particleDataStream);
+  // the k4Gen specific settings are part of the cache, a missing one means the cache is unusable
+  if (!m_pythiaSignal->settings.isFlag("ResonanceDecayFilter:filter") ||
+      !m_pythiaSignal->settings.isFlag("KinematicPreselection:filter")) {
+    warning() << "Cached Pythia8 initialization state " << prefix << " is incomplete, ignoring it" << endmsg;
+    m_pythiaSignal.reset();
+    return;
+  }
+  info() << "Restored Pythia8 settings and particle data from " << prefix << endmsg;
+}
+
+void PythiaInterface::saveInitCache(const std::string& key) {
+  const std::string prefix = m_initCacheDir.value() + "/pythia_" + key;
+  // write to temporary files first so that concurrent jobs never read a partial cache
+  const std::string tmpSuffix = ".tmp" + std::to_string(System::procID());
+  {
+    std::ofstream settingsStream(prefix + ".settings.xml" + tmpSuffix);
+    if (!settingsStream.good() || !m_pythiaSignal->settings.writeFileXML(settingsStream)) {
+      warning() << "Could not write Pythia8 initialization cache to " << m_initCacheDir.value() << endmsg;
+      return;
+    }
+  }
+  m_pythiaSignal->particleData.listXML(prefix + ".particledata.xml" + tmpSuffix);
+  if (std::rename((prefix + ".particledata.xml" + tmpSuffix).c_str(), (prefix + ".particledata.xml").c_str()) != 0 ||
+      std::rename((prefix + ".settings.xml" + tmpSuffix).c_str(), (prefix + ".settings.xml").c_str()) != 0) {
+    warning() << "Could not write Pythia8 initialization cache to " << m_initCacheDir.value() << endmsg;
+    return;
+  }
+  info() << "Saved Pythia8 settings and particle data to " << prefix << endmsg;
+}
+
+std::string PythiaInterface::prepareEvtGenDecayCache() {
+  const std::string globalDecays = readWholeFile(m_EvtGenDecayFile.value());
+  const std::string userDecays = m_UserDecayFile.empty() ? "" : readWholeFile(m_UserDecayFile.value());
+  if (globalDecays.empty()) {
+    warning() << "Could not read EvtGen decay file " << m_EvtGenDecayFile.value() << ", not using the cache" << endmsg;
+    return "";
+  }
+  if (!m_UserDecayFile.empty() && userDecays.empty()) {
+    warning() << "Could not read EvtGen user decay file " << m_UserDecayFile.value() << ", not using the cache"
+              << endmsg;
+    return "";
+  }
+
+  const std::string particleData = readWholeFile(m_EvtGenParticleDataFile.value());
+  if (particleData.empty()) {
+    warning() << "Could not read EvtGen particle data file " << m_EvtGenParticleDataFile.value()
+              << ", not using the cache" << endmsg;
+    return "";
+  }
+
+  const std::string cacheFile = m_initCacheDir.value() + "/evtgen_" +
+                                fnv1aHash(globalDecays + '\n' + userDecays + '\n' + particleData) + ".dec";
+  if (std::ifstream(cacheFile).good()) {
+    info() << "Using cached EvtGen decay table " << cacheFile << endmsg;
+    return cacheFile;
+  }
+
+  const std::string merged = EvtGenDecayCache::mergeDecayFiles(globalDecays, userDecays, particleData);
+  if (merged.empty()) {
+    warning() << "Could not merge the EvtGen decay files, not using the cache" << endmsg;
+    return "";
+  }
+
+  // write to a temporary file first so that concurrent jobs never read a partial cache
+  const std::string tmpFile = cacheFile + ".tmp" + std::to_string(System::procID());
+  {
+    std::ofstream output(tmpFile);
+    output << merged;
+    if (!output.good()) {
+      warning() << "Could not write EvtGen decay cache to " << m_initCacheDir.value() << endmsg;
+      return "";
+    }
+  }
+  if (std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+    warning() << "Could not write EvtGen decay cache to " << m_initCacheDir.value() << endmsg;
+    return "";
+  }
+  info() << "Saved merged EvtGen decay table to " << cacheFile << endmsg;
+  return cacheFile;
+}
+
 StatusCode PythiaInterface::getNextEvent(HepMC3::GenEvent& theEvent) {
   // Generate events. Quit if many failures in a row
   int nAborts = 0;
   while (!m_pythiaSignal->next()) {
-    if (++nAborts > m_maxAborts) {
+    if (++nAborts > m_maxAborts || (m_lhePrefetcher && m_pythiaSignal->info.atEndOfFile())) {
+      if (m_lhePrefetcher) {
+        const std::string lheError = m_lhePrefetcher->errorMessage();
+        error() << (lheError.empty() ? "End of LHE input reached" : lheError) << endmsg;
+      }
       IIncidentSvc* incidentSvc;
       incidentSvc = service<IIncidentSvc>("IncidentSvc", false);
       incidentSvc->fireIncident(Incident(name(), IncidentType::AbortEvent));
@@ -186,30 +410,12 @@ StatusCode PythiaInterface::getNextEvent(HepMC3::GenEvent& theEvent) {
   if (m_doEvtGenDecays) {
     m_evtgen->decay();
   }
-  if (m_doMePsMatching || m_doMePsMerging) {
+  if (m_computeMePsMatchingVars && (m_doMePsMatching || m_doMePsMerging)) {
     auto mePsMatchingVars = m_handleMePsMatchingVars.createAndPut();
     int njetNow = 0;
-    std::vector<double> dijVec;
-
-    // Construct input for jet algorithm.
-    Pythia8::Event jetInput;
-    jetInput.init("jet input", &(m_pythiaSignal->particleData));
-    jetInput.clear();
-    for (int i = 0; i < m_pythiaSignal->event.size(); ++i)
-      if (m_pythiaSignal->event[i].isFinal() &&
-          (m_pythiaSignal->event[i].colType() != 0 || m_pythiaSignal->event[i].isHadron()))
-        jetInput.append(m_pythiaSignal->event[i]);
-    m_slowJet->setup(jetInput);
-    // Run jet algorithm.
-    std::vector<double> result;
-    while (m_slowJet->sizeAll() - m_slowJet->sizeJet() > 0) {
-      result.push_back(sqrt(m_slowJet->dNext()));
-      m_slowJet->doStep();
-    }
 
-    // Reorder by decreasing multiplicity.
-    for (int i = int(result.size()) - 1; i >= 0; --i)
-      dijVec.push_back(result[i]);
+    if (clusterJets().isFailure())
+      return StatusCode::FAILURE;
 
     // Now get the "number of partons" in the input event, so that
     // we may tag this event accordingly when histogramming. Note
@@ -217,10 +423,9 @@ StatusCode PythiaInterface::getNextEvent(HepMC3::GenEvent& theEvent) {
     // actual number of partons in the input LH event, since some
     // partons may be excluded from the matching.
 
-    bool doShowerKt = m_pythiaSignal->settings.flag("JetMatching:doShowerKt");
-    if (m_doMePsMatching && !doShowerKt)
+    if (m_doMePsMatching && !m_doShowerKt)
       njetNow = m_matching->nMEpartons().first;
-    else if (m_doMePsMatching && doShowerKt) {
+    else if (m_doMePsMatching && m_doShowerKt) {
       njetNow = m_matching->getProcessSubset().size();
     } else if (m_doMePsMerging) {
       njetNow = m_pythiaSignal->settings.mode("Merging:nRequested");
@@ -230,27 +435,22 @@ StatusCode PythiaInterface::getNextEvent(HepMC3::GenEvent& theEvent) {
         njetNow--;
     }
 
-    // Inclusive jet pTs as further validation plot.
-    std::vector<double> ptVec;
-    // Run jet algorithm.
-    m_slowJet->analyze(jetInput);
-    for (int i = 0; i < m_slowJet->sizeJet(); ++i)
-      ptVec.push_back(m_slowJet->pT(i));
-
     // 0th entry = number of generated partons
+    mePsMatchingVars->reserve(9);
     mePsMatchingVars->push_back(njetNow);
 
     // odd  entries: d(ij) observables --- 1): d01, 3): d12, 5): d23, 7): d34
     // even entries: pT(i) observables --- 2): pT1, 4): pT2, 6): pT3, 8): pT4
+    // the clustering scales are recorded in increasing order, i.e. by decreasing multiplicity from the back
     for (unsigned int i = 0; i < 4; ++i) {
-      if (dijVec.size() > i) {
-        mePsMatchingVars->push_back(log10(dijVec[i]));
+      if (m_dijBuffer.size() > i) {
+        mePsMatchingVars->push_back(log10(m_dijBuffer[m_dijBuffer.size() - 1 - i]));
       } else {
         mePsMatchingVars->push_back(-999);
       }
 
-      if (ptVec.size() > i) {
-        mePsMatchingVars->push_back(ptVec[i]);
+      if (m_jetPtBuffer.size() > i) {
+        mePsMatchingVars->push_back(m_jetPtBuffer[i]);
       } else {
         mePsMatchingVars->push_back(-999);
       }
@@ -334,6 +534,51 @@ StatusCode PythiaInterface::getNextEvent(HepMC3::GenEvent& theEvent) {
   return StatusCode::SUCCESS;
 }
 
+StatusCode PythiaInterface::clusterJets() {
+  // Construct input for jet algorithm, reusing the record of the previous event.
+  m_jetInput.clear();
+  for (int i = 0; i < m_pythiaSignal->event.size(); ++i)
+    if (m_pythiaSignal->event[i].isFinal() &&
+        (m_pythiaSignal->event[i].colType() != 0 || m_pythiaSignal->event[i].isHadron()))
+      m_jetInput.append(m_pythiaSignal->event[i]);
+
+  if (m_slowJet) {
+    m_slowJet->setup(m_jetInput);
+    // Run jet algorithm step by step, recording the clustering scales.
+    // Stepping until all clusters are promoted to jets is the same as analyze(),
+    // so the inclusive jets are available afterwards without clustering again.
+    m_dijBuffer.clear();
+    while (m_slowJet->sizeAll() - m_slowJet->sizeJet() > 0) {
+      m_dijBuffer.push_back(sqrt(m_slowJet->dNext()));
+      m_slowJet->doStep();
+    }
+    // Inclusive jet pTs as further validation plot, in decreasing order.
+    m_jetPtBuffer.clear();
+    for (int i = 0; i < m_slowJet->sizeJet(); ++i)
+      m_jetPtBuffer.push_back(m_slowJet->pT(i));
+    std::sort(m_jetPtBuffer.begin(), m_jetPtBuffer.end(), std::greater<double>());
+  }
+
+  if (m_ktClustering) {
+    m_ktClustering->analyze(m_jetInput);
+    if (m_slowJet) {
+      if (!sameWithinTolerance(m_dijBuffer, m_ktClustering->scales()) ||
+          !sameWithinTolerance(m_jetPtBuffer, m_ktClustering->jetPts())) {
+        error() << "KtClustering disagrees with SlowJet: " << m_ktClustering->scales().size() << " vs "
+                << m_dijBuffer.size() << " clustering steps, " << m_ktClustering->jetPts().size() << " vs "
+                << m_jetPtBuffer.size() << " jets" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      ++m_nJetBackendValidated;
+    }
+    if (m_jetBackend == "KtClustering") {
+      m_dijBuffer = m_ktClustering->scales();
+      m_jetPtBuffer = m_ktClustering->jetPts();
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
 StatusCode PythiaInterface::finalize() {
 
   if (m_doPowheg) {
@@ -341,9 +586,27 @@ StatusCode PythiaInterface::finalize() {
     debug() << "POWHEG INFO: Number of FSR emissions vetoed: " << m_nFSRveto << endmsg;
   }
 
-  m_pythiaSignal.reset();
-  if (nullptr != m_evtgen) {
-    delete m_evtgen;
+  if (m_lhePrefetcher) {
+    info() << "LHE prefetcher: " << m_lhePrefetcher->nEventsProvided() << " events provided, generation waited "
+           << m_lhePrefetcher->nStalls() << " times for input" << endmsg;
+    // Pythia keeps a reference to the prefetcher, so stop the reading thread explicitly
+    m_lhePrefetcher->stop();
+  }
+
+  if (m_validateJetBackend && m_ktClustering) {
+    info() << "Jet backend validation: KtClustering and SlowJet agree in " << m_nJetBackendValidated << " events"
+           << endmsg;
+  }
+
+  if (nullptr != m_kinematicPreselectionHook) {
+    info() << "Kinematic preselection: " << m_kinematicPreselectionHook->nProcessChecked() << " hard processes checked, "
+           << m_kinematicPreselectionHook->nProcessVetoed() << " vetoed after the hard process, "
+           << m_kinematicPreselectionHook->nStepVetoed() << " vetoed after the first "
+           << m_pythiaSignal->settings.mode("KinematicPreselection:nShowerSteps") << " shower steps" << endmsg;
   }
+
+  m_pythiaSignal.reset();
+  m_lhePrefetcher.reset();
+  m_evtgen.reset();
   return AlgTool::finalize();
 }
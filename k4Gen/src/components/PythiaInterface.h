@@ -4,6 +4,7 @@
 #include "GaudiKernel/AlgTool.h"
 #include "Generation/IHepMCProviderTool.h"
 #include "Generation/IVertexSmearingTool.h"
+#include "KinematicPreselectionHook.h"
 #include "Pythia8Plugins/HepMC3.h"
 #include "Pythia8Plugins/PowhegHooks.h"
 #include "ResonanceDecayFilterHook.h"
@@ -14,6 +15,8 @@
 namespace HepMC3 {
 class GenEvent;
 }
+class KtClustering;
+class LHEPrefetcher;
 // Forward Pythia
 #if PYTHIA_VERSION_INTEGER < 8300
 class EvtGenDecays;
@@ -57,8 +60,56 @@ private:
   Gaudi::Property<std::vector<std::string>> m_pythia_extrasettings{
       this, "pythiaExtraSettings", {""}, "Additional strings with Pythia settings, applied after the card."};
 
+  /// Directory for the cached Pythia settings, particle data and EvtGen decay tables, keyed by their inputs
+  Gaudi::Property<std::string> m_initCacheDir{
+      this, "initCacheDir", "",
+      "Directory where the configured Pythia settings, particle data and the merged EvtGen decay table are cached "
+      "between jobs. Empty disables it."};
+
+  /// Key of the initialization cache, derived from the Pythia version, card contents and extra settings without seeds
+  std::string computeInitCacheKey(const std::string& xmlpath) const;
+  /// Apply the seed settings of the card and extra settings to the settings restored from the cache
+  void applySeedSettings();
+  /// Construct m_pythiaSignal from the cache, leaves it empty if there is no usable cache entry
+  void loadInitCache(const std::string& key);
+  /// Store the current settings and particle data of m_pythiaSignal in the cache
+  void saveInitCache(const std::string& key);
+  /// Path of the cached EvtGen decay table merged from the global and user decay files, empty if not available
+  std::string prepareEvtGenDecayCache();
+
+  /// LHE files read on a background thread and fed to Pythia, replacing Beams:LHEF
+  Gaudi::Property<std::vector<std::string>> m_lheFiles{
+      this, "LHEFiles", {}, "List of (optionally gzipped) LHE files read as one stream, replaces Beams:LHEF if set"};
+  Gaudi::Property<long> m_lheFirstEvent{this, "LHEFirstEvent", 0, "Number of events to skip in the LHE file stream"};
+  Gaudi::Property<long> m_lheMaxEvents{this, "LHEMaxEvents", -1,
+                                       "Number of events to read from the LHE file stream, -1 for all"};
+  Gaudi::Property<unsigned int> m_lhePrefetchSize{this, "LHEPrefetchSize", 1000,
+                                                  "Maximal number of parsed LHE events kept in memory"};
+  std::shared_ptr<LHEPrefetcher> m_lhePrefetcher{nullptr};
+
+  /// Switch for the ME/PS matching validation variables, only needed in validation jobs
+  Gaudi::Property<bool> m_computeMePsMatchingVars{
+      this, "computeMePsMatchingVars", true,
+      "Compute the ME/PS matching validation variables (mePsMatchingVars) when matching or merging is on"};
+  /// Jet clustering used for the ME/PS matching variables
+  Gaudi::Property<std::string> m_jetBackend{
+      this, "jetBackend", "SlowJet",
+      "Jet clustering for the ME/PS matching variables: SlowJet or KtClustering (nearest-neighbour kT, faster)"};
+  Gaudi::Property<bool> m_validateJetBackend{
+      this, "validateJetBackend", false,
+      "Cluster every event with both SlowJet and KtClustering and fail if the matching variables differ"};
+  /// Fill m_dijBuffer and m_jetPtBuffer from the final state of the current event
+  StatusCode clusterJets();
   /// Pythia8 engine for jet clustering
   std::unique_ptr<Pythia8::SlowJet> m_slowJet{nullptr};
+  /// Nearest-neighbour kT clustering, alternative to m_slowJet
+  std::unique_ptr<KtClustering> m_ktClustering{nullptr};
+  unsigned long m_nJetBackendValidated{0};
+  /// Jet clustering input and results, reused between events
+  Pythia8::Event m_jetInput;
+  std::vector<double> m_dijBuffer;
+  std::vector<double> m_jetPtBuffer;
+  bool m_doShowerKt{false};
   // Output handle for ME/PS matching variables
   mutable k4FWCore::DataHandle<std::vector<float>> m_handleMePsMatchingVars{"mePsMatchingVars", Gaudi::DataHandle::Writer, this};
 
@@ -82,6 +133,9 @@ private:
 
   ResonanceDecayFilterHook* m_resonanceDecayFilterHook{nullptr};
 
+  /// Early veto on hard-process and parton-level kinematics
+  KinematicPreselectionHook* m_kinematicPreselectionHook{nullptr};
+
   /// flag for additional printouts
   Gaudi::Property<bool> m_printPythiaStatistics{this, "printPythiaStatistics", false, "Print Pythia Statistics"};
 
@@ -94,7 +148,7 @@ private:
 
   Gaudi::Property<std::vector<int>> m_evtGenExcludes{
       this, "EvtGenExcludes", {}, "PDG IDs of particles not to decay with EvtGen"};
-  Pythia8::EvtGenDecays* m_evtgen = nullptr;
+  std::unique_ptr<Pythia8::EvtGenDecays> m_evtgen;
 };
 
 #endif // GENERATION_PYTHIAINTERFACE_H
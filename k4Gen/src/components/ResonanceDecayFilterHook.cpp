@@ -2,6 +2,8 @@
 #include "ResonanceDecayFilterHook.h"
 #include "Pythia8/Pythia.h"
 
+#include <algorithm>
+
 using namespace Pythia8;
 
 //--------------------------------------------------------------------------
@@ -14,107 +16,129 @@ bool ResonanceDecayFilterHook::initAfterBeams() {
   udscAsEquivalent_ = settingsPtr->flag("ResonanceDecayFilter:udscAsEquivalent");
   udscbAsEquivalent_ = settingsPtr->flag("ResonanceDecayFilter:udscbAsEquivalent");
   wzAsEquivalent_ = settingsPtr->flag("ResonanceDecayFilter:wzAsEquivalent");
+
+  // the equivalence rules only touch small ids, so they can be tabulated once
+  for (int did = 0; did < kTableSize; ++did) {
+    equivalence_[did] = applyEquivalence(did);
+  }
+
   auto mothers = settingsPtr->mvec("ResonanceDecayFilter:mothers");
-  mothers_.clear();
-  mothers_.insert(mothers.begin(), mothers.end());
-  daughters_ = settingsPtr->mvec("ResonanceDecayFilter:daughters");
+  allMothers_ = mothers.empty();
+  mothers_.reset();
+  heavyMothers_.clear();
+  for (int id : mothers) {
+    int mid = std::abs(id);
+    if (mid < kTableSize) {
+      mothers_.set(mid);
+    } else {
+      heavyMothers_.push_back(mid);
+    }
+  }
 
-  requestedDaughters_.clear();
+  daughters_ = settingsPtr->mvec("ResonanceDecayFilter:daughters");
 
+  daughterSlots_.fill(-1);
+  heavyDaughterSlots_.clear();
+  requestedCounts_.clear();
   for (int id : daughters_) {
-    int did = std::abs(id);
-    if (did == 13 && (eMuAsEquivalent_ || eMuTauAsEquivalent_)) {
-      did = 11;
-    }
-    if (did == 15 && eMuTauAsEquivalent_) {
-      did = 11;
-    }
-    if ((did == 14 || did == 16) && allNuAsEquivalent_) {
-      did = 12;
-    }
-    if ((did == 2 || did == 3 || did == 4) && udscAsEquivalent_) {
-      did = 1;
-    }
-    if ((did == 2 || did == 3 || did == 4 || did == 5) && udscbAsEquivalent_) {
-      did = 1;
-    }
-    if ((did == 23 || did == 24) && wzAsEquivalent_) {
-      did = 23;
+    int did = applyEquivalence(std::abs(id));
+    int slot = daughterSlot(did);
+    if (slot < 0) {
+      slot = static_cast<int>(requestedCounts_.size());
+      requestedCounts_.push_back(0);
+      if (did < kTableSize) {
+        daughterSlots_[did] = slot;
+      } else {
+        heavyDaughterSlots_.emplace_back(did, slot);
+      }
     }
-
-    ++requestedDaughters_[std::abs(did)];
+    ++requestedCounts_[slot];
   }
+  observedCounts_.assign(requestedCounts_.size(), 0);
 
   return true;
 }
 
+//--------------------------------------------------------------------------
+int ResonanceDecayFilterHook::applyEquivalence(int did) const {
+  if (did == 13 && (eMuAsEquivalent_ || eMuTauAsEquivalent_)) {
+    did = 11;
+  }
+  if (did == 15 && eMuTauAsEquivalent_) {
+    did = 11;
+  }
+  if ((did == 14 || did == 16) && allNuAsEquivalent_) {
+    did = 12;
+  }
+  if ((did == 2 || did == 3 || did == 4) && udscAsEquivalent_) {
+    did = 1;
+  }
+  if ((did == 2 || did == 3 || did == 4 || did == 5) && udscbAsEquivalent_) {
+    did = 1;
+  }
+  if ((did == 23 || did == 24) && wzAsEquivalent_) {
+    did = 23;
+  }
+  return did;
+}
+
+//--------------------------------------------------------------------------
+int ResonanceDecayFilterHook::daughterSlot(int did) const {
+  if (did < kTableSize)
+    return daughterSlots_[did];
+  for (const auto& heavy : heavyDaughterSlots_) {
+    if (heavy.first == did)
+      return heavy.second;
+  }
+  return -1;
+}
+
+//--------------------------------------------------------------------------
+bool ResonanceDecayFilterHook::isMother(int mid) const {
+  if (mid < kTableSize)
+    return mothers_.test(mid);
+  return std::find(heavyMothers_.begin(), heavyMothers_.end(), mid) != heavyMothers_.end();
+}
+
 //--------------------------------------------------------------------------
 bool ResonanceDecayFilterHook::checkVetoResonanceDecays(const Event& process) {
-  if (!filter_)
+  if (!filter_ || requestedCounts_.empty())
     return false;
 
-  observedDaughters_.clear();
+  std::fill(observedCounts_.begin(), observedCounts_.end(), 0);
+  int unsatisfied = static_cast<int>(requestedCounts_.size());
 
   // count decay products
+  // inclusive mode: at least as many decay products as requested
+  // exclusive mode: exactly as many decay products as requested
+  //(but additional particle types not appearing in the list of requested daughter id's are ignored)
   for (int i = 0; i < process.size(); ++i) {
     const Particle& p = process[i];
 
     int did = std::abs(p.id());
-
-    if (did == 13 && (eMuAsEquivalent_ || eMuTauAsEquivalent_)) {
-      did = 11;
-    }
-    if (did == 15 && eMuTauAsEquivalent_) {
-      did = 11;
-    }
-    if ((did == 14 || did == 16) && allNuAsEquivalent_) {
-      did = 12;
-    }
-    if ((did == 2 || did == 3 || did == 4) && udscAsEquivalent_) {
-      did = 1;
-    }
-    if ((did == 2 || did == 3 || did == 4 || did == 5) && udscbAsEquivalent_) {
-      did = 1;
-    }
-    if ((did == 23 || did == 24) && wzAsEquivalent_) {
-      did = 23;
-    }
-
-    int mid = p.mother1() > 0 ? std::abs(process[p.mother1()].id()) : 0;
+    int slot = daughterSlot(did < kTableSize ? equivalence_[did] : did);
+    if (slot < 0)
+      continue;
 
     // if no list of mothers is provided, then all particles
     // in hard process and resonance decays are counted together
-    if (mothers_.empty() || mothers_.count(mid) || mothers_.count(-mid))
-      ++observedDaughters_[did];
-  }
-
-  // check if criteria is satisfied
-  // inclusive mode: at least as many decay products as requested
-  // exclusive mode: exactly as many decay products as requested
-  //(but additional particle types not appearing in the list of requested daughter id's are ignored)
-  for (const auto& reqpair : requestedDaughters_) {
-    int reqid = reqpair.first;
-    int reqcount = reqpair.second;
-
-    int obscount = 0;
-    for (const auto& obspair : observedDaughters_) {
-      int obsid = obspair.first;
-
-      if (obsid == reqid) {
-        obscount = obspair.second;
-        break;
-      }
+    if (!allMothers_) {
+      int mid = p.mother1() > 0 ? std::abs(process[p.mother1()].id()) : 0;
+      if (!isMother(mid))
+        continue;
     }
 
-    // inclusive criteria not satisfied, veto event
-    if (obscount < reqcount)
-      return true;
-
-    // exclusive criteria not satisfied, veto event
-    if (exclusive_ && obscount > reqcount)
+    int obscount = ++observedCounts_[slot];
+    if (obscount == requestedCounts_[slot]) {
+      // inclusive criteria satisfied for all requested daughters, don't veto
+      if (--unsatisfied == 0 && !exclusive_)
+        return false;
+    } else if (exclusive_ && obscount > requestedCounts_[slot]) {
+      // exclusive criteria not satisfied, veto event
       return true;
+    }
   }
 
-  // all criteria satisfied, don't veto
-  return false;
+  // veto if some inclusive criteria are not satisfied
+  return unsatisfied > 0;
 }
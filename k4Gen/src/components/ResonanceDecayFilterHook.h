@@ -4,6 +4,10 @@
 #include "Pythia8/Event.h"
 #include "Pythia8/UserHooks.h"
 
+#include <array>
+#include <bitset>
+#include <vector>
+
 class ResonanceDecayFilterHook : public Pythia8::UserHooks {
 public:
   // Constructor and destructor.
@@ -19,6 +23,17 @@ public:
   //--------------------------------------------------------------------------
 
 private:
+  /// Size of the dense lookup tables, covers quarks, leptons and the gauge and Higgs bosons.
+  /// Particles with larger |PDG id| fall back to a linear search over a short list.
+  static constexpr int kTableSize = 64;
+
+  /// Equivalence class representative of an absolute PDG id, applying the configured rules
+  int applyEquivalence(int did) const;
+  /// Slot in the requested-daughter counters for an equivalence-mapped id, -1 if not requested
+  int daughterSlot(int did) const;
+  /// Whether particles with this absolute mother id are counted
+  bool isMother(int mid) const;
+
   bool filter_;
   bool exclusive_;
   bool eMuAsEquivalent_;
@@ -27,10 +42,19 @@ private:
   bool udscAsEquivalent_;
   bool udscbAsEquivalent_;
   bool wzAsEquivalent_;
-  std::set<int> mothers_;
   std::vector<int> daughters_;
 
-  std::map<int, int> requestedDaughters_;
-  std::map<int, int> observedDaughters_;
+  /// |PDG id| -> equivalence class representative, precomputed in initAfterBeams
+  std::array<int, kTableSize> equivalence_;
+  /// if no list of mothers is provided, all particles are counted
+  bool allMothers_;
+  std::bitset<kTableSize> mothers_;
+  std::vector<int> heavyMothers_;
+
+  /// |PDG id| -> slot in requestedCounts_/observedCounts_, -1 if not requested
+  std::array<int, kTableSize> daughterSlots_;
+  std::vector<std::pair<int, int>> heavyDaughterSlots_;
+  std::vector<int> requestedCounts_;
+  std::vector<int> observedCounts_;
 };
 #endif
@@ -0,0 +1,43 @@
+#include "SampleStatistics.h"
+
+#include <cmath>
+
+void RunningMoments::merge(const RunningMoments& other) {
+  if (other.m_n == 0)
+    return;
+  const unsigned long n = m_n + other.m_n;
+  const double delta = other.m_mean - m_mean;
+  m_m2 += other.m_m2 + delta * delta * (double(m_n) * double(other.m_n) / n);
+  m_mean += delta * (double(other.m_n) / n);
+  m_n = n;
+}
+
+void SampleStatistics::addParticle(int pdgId, double charge, double pt, double eta) {
+  ++m_particlesInEvent;
+  if (charge != 0.)
+    ++m_charged;
+  ++m_pdgCounts[pdgId];
+  m_pt.add(pt);
+  if (std::isfinite(eta))
+    m_eta.add(eta);
+}
+
+void SampleStatistics::endEvent() {
+  m_multiplicity.add(m_particlesInEvent);
+  m_particles += m_particlesInEvent;
+  m_particlesInEvent = 0;
+}
+
+void SampleStatistics::merge(const SampleStatistics& other) {
+  m_multiplicity.merge(other.m_multiplicity);
+  m_pt.merge(other.m_pt);
+  m_eta.merge(other.m_eta);
+  m_particles += other.m_particles;
+  m_charged += other.m_charged;
+  for (const auto& count : other.m_pdgCounts)
+    m_pdgCounts[count.first] += count.second;
+}
+
+double SampleStatistics::chargedFraction() const {
+  return m_particles > 0 ? double(m_charged) / m_particles : 0.;
+}
@@ -0,0 +1,65 @@
+#ifndef GENERATION_SAMPLESTATISTICS_H
+#define GENERATION_SAMPLESTATISTICS_H
+
+#include <unordered_map>
+
+/** @class RunningMoments
+ *
+ *  Number of entries, mean and variance of a quantity, updated with Welford's algorithm so that they are accurate for
+ *  any number of entries. Two sets of moments are merged exactly (Chan et al.).
+ */
+class RunningMoments {
+public:
+  void add(double x) {
+    ++m_n;
+    const double delta = x - m_mean;
+    m_mean += delta / m_n;
+    m_m2 += delta * (x - m_mean);
+  }
+  void merge(const RunningMoments& other);
+
+  unsigned long entries() const { return m_n; }
+  double mean() const { return m_mean; }
+  /// unbiased sample variance
+  double variance() const { return m_n > 1 ? m_m2 / (m_n - 1) : 0.; }
+
+private:
+  unsigned long m_n{0};
+  double m_mean{0.};
+  /// sum of squared deviations from the mean
+  double m_m2{0.};
+};
+
+/** @class SampleStatistics
+ *
+ *  Summary of the final-state particles of a generated sample: multiplicity per event, charged fraction, exact counts
+ *  by PDG code and the moments of pt and eta. It is filled one particle at a time, and the statistics of several
+ *  threads or jobs are combined with merge().
+ */
+class SampleStatistics {
+public:
+  /// Add a final-state particle of the current event; pt in GeV
+  void addParticle(int pdgId, double charge, double pt, double eta);
+  /// Close the current event
+  void endEvent();
+  void merge(const SampleStatistics& other);
+
+  unsigned long events() const { return m_multiplicity.entries(); }
+  const RunningMoments& multiplicity() const { return m_multiplicity; }
+  const RunningMoments& pt() const { return m_pt; }
+  const RunningMoments& eta() const { return m_eta; }
+  /// fraction of the final-state particles that are charged
+  double chargedFraction() const;
+  const std::unordered_map<int, unsigned long>& pdgCounts() const { return m_pdgCounts; }
+
+private:
+  RunningMoments m_multiplicity;
+  RunningMoments m_pt;
+  /// particles along the beam, with infinite eta, are left out
+  RunningMoments m_eta;
+  unsigned long m_particles{0};
+  unsigned long m_charged{0};
+  std::unordered_map<int, unsigned long> m_pdgCounts;
+  unsigned long m_particlesInEvent{0};
+};
+#endif
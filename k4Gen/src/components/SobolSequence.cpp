@@ -0,0 +1,55 @@
+
+#include "SobolSequence.h"
+
+namespace {
+/// degree s, coefficients a and initial numbers m of the primitive polynomials of dimensions 2 to 6
+struct Polynomial {
+  unsigned int s;
+  unsigned int a;
+  std::array<std::uint32_t, 4> m;
+};
+constexpr std::array<Polynomial, SobolSequence::maxDimensions - 1> polynomials{{
+    {1, 0, {1, 0, 0, 0}},
+    {2, 1, {1, 3, 0, 0}},
+    {3, 1, {1, 3, 1, 0}},
+    {3, 2, {1, 1, 1, 0}},
+    {4, 1, {1, 1, 3, 3}},
+}};
+} // namespace
+
+SobolSequence::SobolSequence() {
+  // first dimension: van der Corput sequence in base 2
+  for (unsigned int i = 0; i < m_bits; ++i)
+    m_directions[0][i] = std::uint32_t(1) << (m_bits - 1 - i);
+  for (unsigned int d = 1; d < maxDimensions; ++d) {
+    const Polynomial& poly = polynomials[d - 1];
+    auto& v = m_directions[d];
+    for (unsigned int i = 0; i < poly.s; ++i)
+      v[i] = poly.m[i] << (m_bits - 1 - i);
+    for (unsigned int i = poly.s; i < m_bits; ++i) {
+      v[i] = v[i - poly.s] ^ (v[i - poly.s] >> poly.s);
+      for (unsigned int k = 1; k < poly.s; ++k) {
+        if ((poly.a >> (poly.s - 1 - k)) & 1)
+          v[i] ^= v[i - k];
+      }
+    }
+  }
+}
+
+const SobolSequence& SobolSequence::instance() {
+  static const SobolSequence sequence;
+  return sequence;
+}
+
+void SobolSequence::point(std::uint64_t index, unsigned int dimensions, double* x) const {
+  // the Gray code of the index selects the direction numbers
+  std::uint64_t gray = index ^ (index >> 1);
+  for (unsigned int d = 0; d < dimensions && d < maxDimensions; ++d) {
+    std::uint32_t value = 0;
+    for (unsigned int bit = 0; bit < m_bits && (gray >> bit) != 0; ++bit) {
+      if ((gray >> bit) & 1)
+        value ^= m_directions[d][bit];
+    }
+    x[d] = value * (1. / 4294967296.);
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef GENERATION_SOBOLSEQUENCE_H
+#define GENERATION_SOBOLSEQUENCE_H
+
+#include <array>
+#include <cstdint>
+
+/** @class SobolSequence
+ *
+ *  Sobol low-discrepancy sequence in up to six dimensions, with the direction numbers of S. Joe and F. Y. Kuo.
+ *  Every point is computed directly from its index (in Gray code order), so that jobs can use disjoint parts of the
+ *  sequence by starting at different indices. Any 2^k consecutive points starting at a multiple of 2^k are well
+ *  spread. Point 0 is the origin and is better skipped.
+ */
+class SobolSequence {
+public:
+  static constexpr unsigned int maxDimensions = 6;
+
+  /// Coordinates in [0, 1) of the point with the given index, in the first `dimensions` entries of x
+  void point(std::uint64_t index, unsigned int dimensions, double* x) const;
+
+  /// The direction numbers are the same for all users
+  static const SobolSequence& instance();
+
+private:
+  SobolSequence();
+
+  static constexpr unsigned int m_bits = 32;
+  std::array<std::array<std::uint32_t, m_bits>, maxDimensions> m_directions;
+};
+#endif
@@ -0,0 +1,31 @@
+
+#include "StageMonitor.h"
+
+#include <fstream>
+
+bool writeStageSummary(const std::string& filename, const std::string& component,
+                       const Gaudi::Accumulators::StatCounter<double>& total, const StageCounters& counters,
+                       const StageCounts& counts) {
+  std::ofstream out(filename);
+  if (!out.good())
+    return false;
+
+  const double totalSeconds = total.sum() / 1000.;
+  out << "{\n";
+  out << "  \"component\": \"" << component << "\",\n";
+  out << "  \"events\": " << total.nEntries() << ",\n";
+  out << "  \"throughput_per_s\": " << (totalSeconds > 0. ? total.nEntries() / totalSeconds : 0.) << ",\n";
+  for (const auto& count : counts)
+    out << "  \"" << count.first << "\": " << count.second << ",\n";
+  out << "  \"counters\": {";
+  for (size_t i = 0; i < counters.size(); ++i) {
+    const auto& counter = *counters[i].second;
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    \"" << counters[i].first << "\": {\"entries\": " << counter.nEntries() << ", \"sum\": " << counter.sum()
+        << ", \"mean\": " << counter.mean() << ", \"stddev\": " << counter.standard_deviation()
+        << ", \"min\": " << (counter.nEntries() > 0 ? counter.min() : 0.)
+        << ", \"max\": " << (counter.nEntries() > 0 ? counter.max() : 0.) << "}";
+  }
+  out << "\n  }\n}\n";
+  return out.good();
+}
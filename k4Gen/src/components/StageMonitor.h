@@ -0,0 +1,61 @@
+#ifndef GENERATION_STAGEMONITOR_H
+#define GENERATION_STAGEMONITOR_H
+
+#include "Gaudi/Accumulators.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @class StageTimer
+ *
+ *  Wall-clock time of a processing stage, added in milliseconds to a Gaudi counter when the timer goes out of scope.
+ *  A disabled timer does not read the clock, so the instrumentation costs nothing measurable when it is switched off.
+ */
+class StageTimer {
+public:
+  StageTimer(Gaudi::Accumulators::StatCounter<double>& counter, bool enabled)
+      : m_counter(enabled ? &counter : nullptr) {
+    if (m_counter)
+      m_start = std::chrono::steady_clock::now();
+  }
+  /// Add the time to a running sum instead, for stages that are done in several pieces within an event
+  StageTimer(double& sum, bool enabled) : m_sum(enabled ? &sum : nullptr) {
+    if (m_sum)
+      m_start = std::chrono::steady_clock::now();
+  }
+  ~StageTimer() {
+    if (m_counter == nullptr && m_sum == nullptr)
+      return;
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    if (m_counter)
+      (*m_counter) += elapsed;
+    else
+      (*m_sum) += elapsed;
+  }
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+  Gaudi::Accumulators::StatCounter<double>* m_counter{nullptr};
+  double* m_sum{nullptr};
+  std::chrono::steady_clock::time_point m_start;
+};
+
+using StageCounters = std::vector<std::pair<std::string, const Gaudi::Accumulators::StatCounter<double>*>>;
+using StageCounts = std::vector<std::pair<std::string, unsigned long>>;
+
+/** Write the counters of a component as a JSON summary.
+ *  @param[in] filename   output file, overwritten
+ *  @param[in] component  name of the component the counters belong to
+ *  @param[in] total      counter of the total time per event [ms], used for the throughput
+ *  @param[in] counters   all counters to report, with their names
+ *  @param[in] counts     plain event counts to report, e.g. the number of aborts
+ *  @return false if the file could not be written
+ */
+bool writeStageSummary(const std::string& filename, const std::string& component,
+                       const Gaudi::Accumulators::StatCounter<double>& total, const StageCounters& counters,
+                       const StageCounts& counts = {});
+
+#endif // GENERATION_STAGEMONITOR_H
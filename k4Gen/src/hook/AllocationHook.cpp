@@ -0,0 +1,81 @@
+/** Allocation hook for the memory monitoring of the k4Gen components.
+ *
+ *  Replaces the global operator new and delete to count the allocations of every thread and to follow the heap held
+ *  by every thread (what it allocated minus what it freed) and its high-water mark. Everything is kept per thread, so
+ *  the stages of concurrent events do not disturb each other. It is meant to be preloaded into a job:
+ *    LD_PRELOAD=libk4GenAllocationHook.so k4run options.py
+ *  The components find the counters at run time (see MemoryMonitor.h) and report nothing if they are not there.
+ *  The aligned variants of new and delete are left to the standard library and are not counted.
+ */
+
+#include <malloc.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local unsigned long t_allocations = 0;
+thread_local unsigned long t_allocatedBytes = 0;
+thread_local long t_heapBytes = 0;
+thread_local long t_heapPeakBytes = 0;
+
+void* allocate(std::size_t size) noexcept {
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (ptr == nullptr)
+    return nullptr;
+  const long usable = malloc_usable_size(ptr);
+  ++t_allocations;
+  t_allocatedBytes += usable;
+  t_heapBytes += usable;
+  if (t_heapBytes > t_heapPeakBytes)
+    t_heapPeakBytes = t_heapBytes;
+  return ptr;
+}
+
+void release(void* ptr) noexcept {
+  if (ptr == nullptr)
+    return;
+  t_heapBytes -= malloc_usable_size(ptr);
+  std::free(ptr);
+}
+} // namespace
+
+void* operator new(std::size_t size) {
+  void* ptr = allocate(size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+void* operator new[](std::size_t size) {
+  void* ptr = allocate(size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+
+extern "C" {
+/// Number of allocations and allocated bytes of the calling thread since it started
+void k4GenThreadAllocations(unsigned long* allocations, unsigned long* bytes) {
+  *allocations = t_allocations;
+  *bytes = t_allocatedBytes;
+}
+
+/// Heap held by the calling thread in bytes (allocated minus freed by it, negative if it freed memory of other
+/// threads) and its high-water mark
+void k4GenThreadHeap(long* bytes, long* peakBytes) {
+  *bytes = t_heapBytes;
+  *peakBytes = t_heapPeakBytes;
+}
+
+/// Restart the high-water mark of the heap held by the calling thread from the given value
+void k4GenSetThreadHeapPeak(long peakBytes) { t_heapPeakBytes = peakBytes; }
+}
@@ -0,0 +1,20 @@
+# Runs evtGenDecayCacheTest in the two-pass and merged modes and fails if the decay tables differ.
+# Expects TEST_EXECUTABLE, GLOBAL_DECAYS, USER_DECAYS, PARTICLE_DATA and OUTPUT_PREFIX to be defined.
+foreach(mode twopass merged)
+  execute_process(COMMAND ${TEST_EXECUTABLE} ${mode} ${OUTPUT_PREFIX}_${mode}.txt ${GLOBAL_DECAYS} ${USER_DECAYS}
+                          ${PARTICLE_DATA}
+                  RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Building the ${mode} decay table failed")
+  endif()
+  file(READ ${OUTPUT_PREFIX}_${mode}.txt table_${mode})
+endforeach()
+
+if(table_twopass STREQUAL "")
+  message(FATAL_ERROR "The decay table is empty")
+endif()
+if(NOT table_twopass STREQUAL table_merged)
+  message(FATAL_ERROR "The merged decay table differs from reading the decay files one after the other, "
+                      "compare ${OUTPUT_PREFIX}_twopass.txt and ${OUTPUT_PREFIX}_merged.txt")
+endif()
+message(STATUS "The merged and two-pass decay tables agree")
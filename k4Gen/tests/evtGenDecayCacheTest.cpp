@@ -0,0 +1,105 @@
+/** evtGenDecayCacheTest
+ *
+ *  Dumps the EvtGen decay table obtained from the global and user decay files, either read one after the other
+ *  ("twopass", as PythiaInterface does without the cache) or merged into one file ("merged", as with the cache).
+ *  compareDecayTables.cmake runs both and checks that the dumps agree.
+ */
+
+#include "EvtGen/EvtGen.hh"
+#include "EvtGenBase/EvtAbsRadCorr.hh"
+#include "EvtGenBase/EvtDecayBase.hh"
+#include "EvtGenBase/EvtDecayTable.hh"
+#include "EvtGenBase/EvtPDL.hh"
+#include "EvtGenBase/EvtRandomEngine.hh"
+#include "EvtGenExternal/EvtExternalGenList.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "EvtGenDecayCache.h"
+
+namespace {
+class TestRandomEngine : public EvtRandomEngine {
+public:
+  double random() override { return m_flat(m_engine); }
+
+private:
+  std::mt19937_64 m_engine{1};
+  std::uniform_real_distribution<double> m_flat{0., 1.};
+};
+
+std::string readWholeFile(const std::string& filename) {
+  std::ifstream file(filename);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 6) {
+    std::cerr << "usage: " << argv[0] << " twopass|merged <output> <global decays> <user decays> <evt.pdl>"
+              << std::endl;
+    return 2;
+  }
+  const std::string mode = argv[1];
+  const std::string output = argv[2];
+  const std::string globalFile = argv[3];
+  const std::string userFile = argv[4];
+  const std::string particleDataFile = argv[5];
+
+  std::string decayFile = globalFile;
+  if (mode == "merged") {
+    const std::string merged = EvtGenDecayCache::mergeDecayFiles(readWholeFile(globalFile), readWholeFile(userFile),
+                                                                 readWholeFile(particleDataFile));
+    if (merged.empty()) {
+      std::cerr << "Could not merge the decay files" << std::endl;
+      return 1;
+    }
+    decayFile = output + ".dec";
+    std::ofstream(decayFile) << merged;
+  } else if (mode != "twopass") {
+    std::cerr << "Unknown mode " << mode << std::endl;
+    return 2;
+  }
+
+  TestRandomEngine randomEngine;
+  const char* xmlDir = std::getenv("PYTHIA8_XML");
+  EvtExternalGenList genList(true, xmlDir ? xmlDir : "", "gamma", true);
+  EvtAbsRadCorr* radCorr = genList.getPhotosModel();
+  std::list<EvtDecayBase*> models = genList.getListOfModels();
+  EvtGen evtgen(decayFile, particleDataFile, &randomEngine, radCorr, &models);
+  if (mode == "twopass")
+    evtgen.readUDecay(userFile);
+
+  // Decay modes by parent name, in the order of the table
+  std::map<std::string, std::vector<std::string>> modes;
+  EvtDecayTable* table = EvtDecayTable::getInstance();
+  for (size_t ipar = 0; ipar < EvtPDL::entries(); ++ipar) {
+    for (int imode = 0; imode < table->getNMode(ipar); ++imode) {
+      EvtDecayBase* decay = table->getDecay(ipar, imode);
+      std::ostringstream line;
+      line << decay->getBranchingFraction() << ' ' << decay->getModelName();
+      for (int i = 0; i < decay->getNDaug(); ++i)
+        line << ' ' << EvtPDL::name(decay->getDaug(i));
+      for (int i = 0; i < decay->getNArg(); ++i)
+        line << ' ' << decay->getArg(i);
+      modes[EvtPDL::name(decay->getParentId())].push_back(line.str());
+    }
+  }
+
+  std::ofstream out(output);
+  for (const auto& parent : modes) {
+    out << parent.first << '\n';
+    for (const auto& line : parent.second)
+      out << "  " << line << '\n';
+  }
+  return out.good() ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+/** particlePropertiesTest
+ *
+ *  Compares the compiled-in table of ParticleProperties with the Pythia8 particle database, so that the copied
+ *  values cannot drift silently. Masses, widths and lifetimes have to agree to 1%, which tolerates the small updates
+ *  between Pythia8 versions but catches wrong units or entries, the charges exactly.
+ */
+
+#include "ParticleProperties.h"
+
+#include "GaudiKernel/System.h"
+#include "Pythia8/Pythia.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace {
+bool agree(double a, double b) { return a == b || std::abs(a - b) <= 0.01 * std::max(std::abs(a), std::abs(b)); }
+} // namespace
+
+int main() {
+  std::string xmlpath = "../share/Pythia8/xmldoc";
+  if (System::getEnv("PYTHIA8_XML") != "UNKNOWN")
+    xmlpath = System::getEnv("PYTHIA8_XML");
+  Pythia8::Pythia pythia(xmlpath, false);
+  auto& data = pythia.particleData;
+  const auto& table = ParticleProperties::instance();
+
+  int failures = 0;
+  for (int pdgId : ParticleProperties::compiledInPdgIds()) {
+    if (!data.isParticle(pdgId)) {
+      std::cout << pdgId << ": not in the Pythia8 database" << std::endl;
+      ++failures;
+      continue;
+    }
+    const auto properties = table.properties(pdgId);
+    const std::pair<const char*, std::pair<double, double>> values[] = {
+        {"mass", {properties.mass, data.m0(pdgId)}},
+        {"width", {properties.width, data.mWidth(pdgId)}},
+        {"ctau", {properties.ctau, data.tau0(pdgId)}}};
+    for (const auto& value : values) {
+      if (!agree(value.second.first, value.second.second)) {
+        std::cout << pdgId << ": " << value.first << " " << value.second.first << ", Pythia8 " << value.second.second
+                  << std::endl;
+        ++failures;
+      }
+    }
+    if (properties.charge != data.charge(pdgId) || table.charge(-pdgId) != data.charge(-pdgId)) {
+      std::cout << pdgId << ": charge " << properties.charge << ", Pythia8 " << data.charge(pdgId) << std::endl;
+      ++failures;
+    }
+  }
+  if (failures > 0) {
+    std::cout << failures << " differences to the Pythia8 particle database" << std::endl;
+    return 1;
+  }
+  std::cout << "The compiled-in particle properties agree with the Pythia8 particle database" << std::endl;
+  return 0;
+}
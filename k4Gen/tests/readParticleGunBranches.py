@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+"""Read back the ParticleGun_* collections written by options/particleGun.py and check their content."""
+
+import math
+import sys
+
+from podio.root_io import Reader
+
+reader = Reader(sys.argv[1] if len(sys.argv) > 1 else "output_particleGun.root")
+events = reader.get("events")
+if len(events) == 0:
+    sys.exit("no events in the output file")
+
+for event in events:
+    pt, eta, costheta, phi = (event.get("ParticleGun_" + name) for name in ("Pt", "Eta", "costheta", "Phi"))
+    if not len(pt) == len(eta) == len(costheta) == len(phi) == 1:
+        sys.exit("expected one entry per particle gun collection")
+    # the signal gun of options/particleGun.py generates pt = 50 MeV, eta in [-3.5, 3.5] and phi in [0, 2 pi)
+    if abs(pt[0] - 0.05) > 1e-6:
+        sys.exit(f"unexpected pt {pt[0]}")
+    if abs(eta[0]) > 3.5 or not 0 <= phi[0] < 2 * math.pi:
+        sys.exit(f"unexpected eta {eta[0]} or phi {phi[0]}")
+    if abs(costheta[0] - math.tanh(eta[0])) > 1e-5:
+        sys.exit(f"cos(theta) {costheta[0]} does not match eta {eta[0]}")
+
+print(f"Read the particle gun collections of {len(events)} events")